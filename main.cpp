@@ -1,507 +1,5153 @@
-/***************************************************************************
- * File: main.c
- * Author: Venkata Bapanapalli
- * Procedures:
- * PROCESS - struct with task info stream elements.
- * rePROCESS - resets info stream's elements to allow them to be processed again.
- * allProcessQue - set un-queued tasks to false while queued tasks are set to true.
- * searchArr - search array used for first-fit and next-fit algorithms.
- * addToMem - Place tasks into memory.
- * incrementTime - Scheduling algorithm to time algorithms.
- * biggest - find the biggest memory size, used for worst-fit algorithm.
- * smallest - find the smalled memory size, used for best-fit algorithm.
- * bestFit - implements the best fit memory partitioning algorithm.
- * firstFit - implements the first fit memory partitioning algorithm.
- * nextFit - implements the next fit memory partitioning algorithm.
- * worstFit - implements the worst fit memory partitioning algorithm.
- * uniform - uniform random number generator.
- * normal - normal random number generator.
- * main - populates the stream struct with random values for size and time,
-         then run 1000 experiments and print average for each algorithm.
-***************************************************************************/
-#include <iostream>
-#include <cstdlib>
-#include <string>
-using namespace std;
-
-int MEM_FREE = 56;
-int NUM_PROCESSES = 1000;
-/***************************************************************************
- * struct PROCESS
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: struct that defines the info stream.
- * Parameters:
- * N/A
-**************************************************************************/
-struct PROCESS
-{
-    int size;                                         // holds the size of each task
-    int time;                                         // holds the time of each task
-    int tTime = 0;                                    // holds the time taken to process the task
-    int oTime = time;                                 // holds the original time of each task
-    int location = -1;                                // location in memory
-    bool isComplete = false;                          // checks if the task is completed
-    bool queued = false;                              // checks if a task is queued
-};
-/***************************************************************************
- * void rePROCESS(PROCESS* arr[])
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: resets info stream's elements to allow them to be processed again.
- * Parameters:
- * arr[]  I/P  PROCESS  passes the dynamic array of the PROCESS struct
-**************************************************************************/
-void rePROCESS(PROCESS* arr[])
-{
-    for(int i=0; i<NUM_PROCESSES; i++)                  		// resets 1000 tasks to be reprocessed
-    {
-        arr[i]->tTime = 0;
-        arr[i]->location = -1;
-        arr[i]->isComplete = false;
-        arr[i]->queued = false;
-        arr[i]->time = arr[i]->oTime;
-    }
-}
-/***************************************************************************
- * bool allProcessesQue(PROCESS* arr[])
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: queued tasks to true, allowing them to be distinguished from un-queued tasks.
- * Parameters:
- * arr[]  I/P  PROCESS  passes the dynamic array of the PROCESS struct
-**************************************************************************/
-bool allProcessesQue(PROCESS* arr[])
-{
-    bool current = true;
-    for(int i=0; i<NUM_PROCESSES; i++)                    		// sets all queued tasks to true
-    {
-        if (!arr[i]->queued)
-        {
-            current = false;
-        }
-    }
-    return current;
-}
-/***************************************************************************
- * int searchArr(PROCESS* mem[], int startPos,  int tSize)
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: search array used to search for specific tasks to place in memory.
- * Parameters:
- * mem       I/P    PROCESS *[]  The mem dynamic array struct
- * startPos  I/P    int          Holds the start position of the dynamic array
- * tSize     I/P    int          Holds the size of the task
-**************************************************************************/
-int searchArr(PROCESS* mem[], int startPos,  int tSize)
-{
-    for(int i=startPos; i<MEM_FREE; i++)
-    {
-        bool toPlace = true;
-        for(int j = i; j < tSize + i; j++ )                 		// search from current index
-        {
-            if (j >= MEM_FREE || mem[j] != nullptr )
-            {
-                toPlace = false;
-                break;
-            }
-        }
-        if (toPlace)
-        {
-            return i;
-        }
-    }
-    for(int i=0; i<startPos; i++)                       		// returns to the beginning
-    {
-        bool toPlace = true;
-        for(int j = i; j < tSize + i; j++ )             		// Search starting from index i
-        {                                               
-            if (j >= MEM_FREE || mem[j] != nullptr )
-            {
-                toPlace = false;
-                break;
-            }
-        }
-        if (toPlace)
-        {
-            return i;
-        }
-    }
-    return -1;
-}
-/***************************************************************************
- * void addToMem(PROCESS* mem[], PROCESS*& placeItem, int put)
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: Adds tasks to the memory
- * Parameters:
- * mem         I/P   PROCESS*[]   holds the memory array
- * placeItem   I/P   PROCESS*&    holds the item that needs to be placed in memory
- * put         I/P   int          index of the value that needs to be placed in memory
-**************************************************************************/
-void addToMem(PROCESS* mem[], PROCESS*& placeItem, int put)
-{
-    for(int i=0; i<placeItem->size; i++)            			// adds specific tasks to memory
-    {
-        mem[put + i] = placeItem;
-    }
-    placeItem->queued = true;
-    placeItem->location = put;
-}
-/***************************************************************************
- * void incrementTime(PROCESS* mem[], PROCESS* arr[], int& totalTime, int current)
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: This is the scheduling function which will output total time taken for each algorithm.
- * Parameters:
- * mem        I/P       PROCESS*[]   memory array
- * arr        I/P       PROCESS*[]   info stream
- * totalTime  O/P       int&         total time value
- * current    I/P       int          index of the current position
-**************************************************************************/
-void incrementTime(PROCESS* mem[], PROCESS* arr[], int& totalTime, int current)
-{
-    for(int i = 0; i<current; i++)                          		// Decrease total time for items on stream
-    {
-        arr[i]->time--;
-        arr[i]->tTime++;
-        if (arr[i]->time == 0)                              		// Task completed: Remove from memory
-        {
-            arr[i]->isComplete = true;
-            for( int k = arr[i]->location; k < arr[i]->location + arr[i]->size; k++)
-            {
-                mem[k] = nullptr;
-            }
-        }
-    }
-    totalTime++;
-}
-/***************************************************************************
- * void biggest(PROCESS* mem[], int& index, int& indexSize, int sizeReq)
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: finds the biggest memory block, this is used for the worst case algorithm.
- * Parameters:
- * mem         I/P  PROCESS*[]   memory array
- * index       O/P  int&         will hold the value of the largest memory block
- * indexSize   I/P  int&         holds the value of the largest memory block
- * sizeReq     I/P  int          holds the value of the space needed for the task
-**************************************************************************/
-void biggest(PROCESS* mem[], int& index, int& indexSize, int sizeReq)
-{
-    index = -1, indexSize = 0;
-    for(int i=0; i< MEM_FREE; i++)                                              // go through the memory
-    {
-        if (mem[i] == nullptr)                                                  // check if the size is in memory
-        {
-            for(int j=0; j + i < MEM_FREE; j++)
-            {
-                if(mem[i+j] != nullptr || i+j == MEM_FREE - 1)                  // check if memory spot is filled
-                {
-                    if ( j+1 > indexSize && j+1 >= sizeReq )                    // Check if counter is greater than the previous biggest
-                    {
-                        indexSize = j;                                          // Update previous biggest memory value
-                        index = i;
-                    }
-                    break;
-                }
-            }
-        }
-    }
-}
-/***************************************************************************
- * void smallest(PROCESS* mem[], int& index, int& indexSize, int sizeReq)
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: finds the smallest memory block needed in the bestfit algorithm.
- * Parameters:
- * mem         I/P  PROCESS*[]   memory array
- * index       O/P  int&         will hold the value of the smallest memory block
- * indexSize   I/P  int&         holds the value of the smallest memory block
- * sizeReq     I/P  int          holds the value of the space needed for the task
-**************************************************************************/
-void smallest(PROCESS* mem[], int& index, int& indexSize, int sizeReq)
-{
-    indexSize = MEM_FREE + 1, index = -1;
-    for(int i=0; i< MEM_FREE; i++)
-    {
-        if (mem[i] == nullptr)                                                   // check if the size is in memory
-        {
-            for(int j=0; j + i < MEM_FREE; j++)
-            {
-                if(mem[i+j] != nullptr || i+j == MEM_FREE - 1)                  // check if the memory spot if full
-                {
-                    if (j + 1< indexSize && j + 1 >= sizeReq )                  // check if value is smaller than previous
-                    {
-                        indexSize = j;                                          // Update previous smallest
-                        index = i;
-                    }
-                    break;
-                }
-            }
-        }
-    }
-}
-/***************************************************************************
- * int bestFit (PROCESS* arr[])
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: bestfit algorithm that finds the block that is closest to size of the task.
- * Parameters:
- * arr   I/P   PROCESS*[]   info stream of tasks to be processed in memory
-**************************************************************************/
-int bestFit (PROCESS* arr[])
-{
-    PROCESS* mem[MEM_FREE];                                                         // Creates array of dynamic objects
-    for(int i=0; i<MEM_FREE; i++)
-    {
-        mem[i] = nullptr;
-    }
-    int totalTime = 0;                                                    
-    int current = 0;
-    int bestIndex = -1, bestSize = MEM_FREE + 1;
-    while ( !allProcessesQue(arr) )                                                 // While not all tasks have been placed
-    {
-        do
-        {
-            smallest(mem, bestIndex, bestSize, arr[current]->size);
-            if (bestIndex >= 0)
-            {
-
-                addToMem(mem, arr[current], bestIndex);                         // Place item on taskStream at index
-
-                current++;
-            }
-        }while(bestIndex >= 0 && current < NUM_PROCESSES);                         // Continue while we can place the item
-
-        incrementTime(mem, arr, totalTime, current);
-    }
-    int biggestTime = 0;
-    for(int i=0; i<MEM_FREE; i++)
-    {
-        if (mem[i] != nullptr)
-        {
-            if (mem[i]->time > biggestTime)
-            {
-                biggestTime = mem[i]->time;
-            }
-        }
-    }
-    totalTime+=biggestTime;
-    rePROCESS(arr);
-    return totalTime;
-}
-/***************************************************************************
- * int firstFit (PROCESS* arr[])
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: firstfit algorithm that finds the first closest block capable of processing the task in memory.
- * Parameters:
- * arr   I/P   PROCESS*[]   info stream of tasks to be processed in memory
-**************************************************************************/
-int firstFit(PROCESS* arr[])
-{
-    PROCESS* mem[MEM_FREE];                                                     // Creates array of dynamic objects
-    for(int i=0; i<MEM_FREE; i++)
-    {
-        mem[i] = nullptr;
-    }
-    int totalTime = 0; 
-    int current = 0;
-    while ( !allProcessesQue(arr) )                                           // While not all tasks have been placed.
-    {
-        int put;
-        do
-        {
-            put = searchArr(mem, 0, arr[current]->size);               	     // Check if item can be placed
-            if (put >= 0)
-            {
-                addToMem(mem, arr[current], put);                           // Place item on taskStream at index
-                current++;
-            }
-        }while(put >= 0 && current < NUM_PROCESSES);                      // Continue while we can place the item
-        incrementTime(mem, arr, totalTime, current);
-    }
-    int biggestTime = 0;
-    for(int i=0; i<MEM_FREE; i++)
-    {
-        if (mem[i] != nullptr)
-        {
-            if (mem[i]->time > biggestTime)
-            {
-                biggestTime = mem[i]->time;
-            }
-        }
-    }
-    totalTime+=biggestTime;
-    rePROCESS(arr);
-    return totalTime;
-}
-/***************************************************************************
- * int nextFit (PROCESS* arr[])
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: nextFit algorithm
- * Parameters:
- * arr   I/P   PROCESS*[]   info stream of tasks to be processed in memory
-**************************************************************************/
-int nextFit(PROCESS* arr[])
-{
-    PROCESS* mem[MEM_FREE];                             	// Creates array of dynamic objects
-    for(int i=0; i<MEM_FREE; i++)
-    {
-        mem[i] = nullptr;
-    }
-    int totalTime = 0;  
-    int current = 0;
-    int last = 0;
-    int put = 0;
-    while ( !allProcessesQue(arr) )                     	// While not all tasks have been placed.
-    {
-        do
-        {
-            if (last == -1)
-            {
-                last = 0;
-            }
-            put = searchArr(mem, last , arr[current]->size);    // Check if item can be placed
-            if (put >= 0)
-            {
-                last = put;
-                addToMem(mem, arr[current], put);           	// Place item on taskStream at put
-                current++;
-            }
-        }while(put >= 0 && current < NUM_PROCESSES);            // Continue while we can place the item
-        incrementTime(mem, arr, totalTime, current);
-    }
-    int biggestTime = 0;
-    for(int i=0; i<MEM_FREE; i++)
-    {
-        if (mem[i] != nullptr)
-        {
-            if (mem[i]->time > biggestTime)
-            {
-                biggestTime = mem[i]->time;
-            }
-        }
-    }
-    rePROCESS(arr);
-    return totalTime;
-}
-/***************************************************************************
- * int worstFit (PROCESS* arr[])
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: worstFit algorithm that finds the block that is biggest capable of processing the task.
- * Parameters:
- * arr   I/P   PROCESS*[]   info stream of tasks to be processed in memory
-**************************************************************************/
-int worstFit(PROCESS* arr[])
-{
-    PROCESS* mem[MEM_FREE];                                             // Creates array of dynamic objects
-    for(int i=0; i<MEM_FREE; i++)
-    {
-        mem[i] = nullptr;
-    }
-    int totalTime = 0, current = 0, worst = -1, worstSize = 0;
-    while ( !allProcessesQue(arr) )                                     // While not all tasks have been placed.
-    {
-        do{
-            biggest(mem, worst, worstSize, arr[current]->size);
-            if (worst >= 0)
-            {
-                addToMem(mem, arr[current], worst);                  	// Place item on taskStream at put
-                current++;
-            }
-        }while(worst >= 0 && current < NUM_PROCESSES);                  // Continue while we can place the item
-        incrementTime(mem, arr, totalTime, current);
-    }
-    int biggestTime = 0;
-    for(int i=0; i<MEM_FREE; i++)
-    {
-        if (mem[i] != nullptr)
-        {
-            if (mem[i]->time > biggestTime)
-            {
-                biggestTime = mem[i]->time;
-            }
-        }
-    }
-    totalTime+=biggestTime;
-    rePROCESS(arr);
-    return totalTime;
-}
-/***************************************************************************
- * int uniform( int lo, int hi )
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: generates a random uniform value
- * Parameters:
- * lo     I/P     int    minimum value
- * hi     I/P     int    maximum value
-**************************************************************************/
-int uniform( int lo, int hi )
-{
-    int x = 0;
-    int y = hi - lo + 1;
-    int z = RAND_MAX / y;
-    while ( (x = rand()) > y * z );
-    return x / z + lo;
-}
-/***************************************************************************
- * int normal( int lo, int hi )
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: generates a random normal value
- * Parameters:
- * loops     I/P     int    number of loops to run
- * ulimit    I/P     int
-**************************************************************************/
-int normal ( int loops, int ulimit )
-{
-    int x = 0;
-    for( int i=0; i< loops; i++ )
-    {
-        x += uniform( 0, ulimit );
-    }
-    return x;
-}
-/***************************************************************************
- * int main( int argc, char *argv[] )
- * Author: Venkata Bapanapalli
- * Date: 19 April 2020
- * Description: populates the info stream with random values for both size and time of task.
- * Then runs all the algoritms 1000 times find the average and prints the results.
- * Parameters:
- * argc    I/P    int        The number of arguments on the command line
- * argv    I/P    char *[]   The arguments on the command line
- * main    O/P    int        Status code (not currently used)
-**************************************************************************/
-int main(int argc, char *argv[])
-{
-    int avg[4] = {0, 0, 0, 0};
-    int numProcesses = 1000;
-    for(int i=0; i<numProcesses; i++)                                   // Loop for 1000 experiments
-    {
-        PROCESS* stream[NUM_PROCESSES];
-        for( int j=0; j < NUM_PROCESSES; j++)                           // Generate Task Info Stream
-        {
-            stream[j] = new PROCESS;
-            stream[j]->size = normal(4,4);
-            if( stream[j]->size < 1 ) stream[j]->size = 1;
-            stream[j]->time = normal(4,4);
-            if( stream[j]->time < 1 ) stream[j]->time = 1;
-            stream[j]->oTime = stream[j]->time;
-        }
-        avg[0] += bestFit(stream);
-        avg[1] += firstFit(stream);
-        avg[2] += nextFit(stream);
-        avg[3] += worstFit(stream);
-    }
-    cout << " BestFit: " << avg[0]/1000 << endl;
-    cout <<  " FirstFit: " << avg[1]/1000<< endl;
-    cout << " NextFit: " << avg[2]/1000 << endl;
-    cout << " WorstFit: " << avg[3]/1000<< endl;
-    return 0;
-}
-
+/***************************************************************************
+ * File: main.c
+ * Author: Venkata Bapanapalli
+ * Procedures:
+ * RNG - xoshiro256++ random number stream, several lanes at once.
+ * seedRng - seeds a stream from a base seed and experiment number.
+ * ARENA - per worker block of memory the info stream columns are carved from.
+ * arenaAlloc - hands out an aligned piece of the arena.
+ * STREAM - task info stream stored as one column per field.
+ * initStream - carves the columns of the info stream out of an arena.
+ * rePROCESS - resets info stream's elements to allow them to be processed again.
+ * TRACE - workload file replayed a window at a time.
+ * openTrace - opens a trace file and detects CSV or binary.
+ * rewindTrace - moves a trace back to its first task.
+ * readTasks - moves the stream window on through a trace.
+ * SNAPSHOT - byte buffer a checkpoint is built in or read from.
+ * putBytes, getBytes, putValue, getValue, putVector, getVector - write and read back a snapshot.
+ * CHECKPOINT - periodic checkpoints of a run, written by a background thread.
+ * checkpointDue - whether it is time for the next checkpoint.
+ * beginCheckpoint - starts a checkpoint with the results of the finished points.
+ * commitCheckpoint - hands a checkpoint to the writer.
+ * writeCheckpoints - writer thread that saves checkpoints to disk.
+ * readCheckpoint - reads the checkpoint of an interrupted run.
+ * finishCheckpoints - stops the writer and removes the checkpoint of a finished run.
+ * TIMELINE, TIMELINE_RING - events of every run, recorded per thread and written by a background thread.
+ * timelineRing - ring of the calling thread.
+ * timelineEvent - records one event.
+ * timelineRun - starts a new run on the calling thread.
+ * writeTimeline, writeEvents - writer thread and the file formats.
+ * startTimeline, finishTimeline - open and close the timeline file.
+ * RELEASE, EVENTS - min-heap of resident extents keyed by the time they leave memory.
+ * COUNTS - live counts of queued, resident and completed tasks.
+ * HOLES - free-extent index of memory, holes by address and by size.
+ * initHoles - resets the free-extent index to one hole covering all of memory.
+ * takeHole - removes a placed task's extent from the free-extent index.
+ * giveHole - returns a released extent to the index, merging with its neighbours.
+ * firstHole - index lookup used for first-fit and next-fit algorithms.
+ * smallestHole - index lookup used for best-fit algorithm.
+ * biggestHole - index lookup used for worst-fit algorithm.
+ * MEMMAP - occupancy bitmap of memory with the owner of each extent.
+ * initMem - clears the memory map.
+ * setUnits - marks a range of units occupied or free.
+ * skipWords - word-at-a-time skip over full or empty parts of the bitmap.
+ * nextHole - finds the next hole in the bitmap.
+ * searchArr - search array used for first-fit and next-fit algorithms.
+ * REGION, MEMORY - memory split into regions, with totals over all of them.
+ * initMemory - splits memory into regions and clears them.
+ * homeOf - region a task prefers.
+ * touchRegion - publishes the state of a region after it changed.
+ * addToMem - Place tasks into memory.
+ * nextRelease - number of ticks until the next resident task leaves memory.
+ * incrementTime - Scheduling algorithm to time algorithms.
+ * biggest - find the biggest memory size, used for worst-fit algorithm.
+ * smallest - find the smalled memory size, used for best-fit algorithm.
+ * takeUnits - reserves a range of units in the memory map and hole index.
+ * freeUnits - frees a range of units in the memory map and hole index.
+ * FIT_POLICY, BEST_FIT, FIRST_FIT, NEXT_FIT, WORST_FIT - placement policies used by simulate.
+ * BUDDY - buddy system placement policy.
+ * QUICK_FIT - segregated free list placement policy.
+ * METRICS - counters and time weighted measurements of one run.
+ * sampleMemory - adds the state of memory to the time weighted metrics.
+ * addMetrics - adds the metrics of one run into a running total.
+ * STATS, addSample, ciHalf - running mean and variance and their confidence interval.
+ * printMetrics - writes metrics as CSV or JSON.
+ * COMPACTION - when memory is compacted and what moving it costs.
+ * compactMem - slides resident extents down into one block.
+ * WORKSPACE - memory an algorithm runs in, reused between runs.
+ * compact - compacts a region and charges the move cost to the clock.
+ * findRegion - finds room for a task in its region or the one it spills to.
+ * SCHEDULER, READY - which waiting task is placed next, and the arrived tasks it picks from.
+ * place - reserves memory for a task and updates the live counts and metrics.
+ * rejectTask - passes over a task too big to ever be placed and counts it.
+ * admitTasks - adds the tasks of the lookahead window that have arrived to READY.
+ * pickTask - the waiting task that goes into the room left.
+ * moveHead - moves the head past queued tasks, keeping the lookahead of a trace loaded.
+ * schedule - places waiting tasks out of stream order.
+ * saveRun - writes the state of a running simulation to a checkpoint.
+ * restoreRun - carries a simulation on from a checkpoint.
+ * simulate - runs the info stream through memory with one placement policy.
+ * bestFit - implements the best fit memory partitioning algorithm.
+ * firstFit - implements the first fit memory partitioning algorithm.
+ * nextFit - implements the next fit memory partitioning algorithm.
+ * worstFit - implements the worst fit memory partitioning algorithm.
+ * buddyFit - implements the buddy system memory partitioning algorithm.
+ * quickFit - implements the quick fit memory partitioning algorithm.
+ * uniform - uniform random number generator.
+ * normal - normal random number generator.
+ * verifyFit - checks one algorithm against the reference scans and a narrow trace window.
+ * DIST, POINT, SWEEP - the grid of configurations to run.
+ * fillColumn - fills a stream column from a distribution in vectorisable batches.
+ * distName - writes a distribution as it is given on the command line.
+ * readHistogram - reads an empirical histogram and builds its alias table.
+ * parseDist - reads a distribution.
+ * setOption - sets one sweep option.
+ * readConfig - reads sweep options from a file.
+ * compactName - writes a compaction trigger as it is given on the command line.
+ * limitName - writes a limit in ticks as it is given on the command line.
+ * pointName - describes a point of the grid.
+ * makeStream - populates the info stream of one experiment from its seed.
+ * RUNNER, WORKER - experiments of one point shared between the worker threads, with per worker state.
+ * runTrials - worker thread that runs the experiments it claims.
+ * saveTrials - checkpoints the experiments of the current point that are done.
+ * resuming - whether a resumed checkpoint holds the progress of the point.
+ * runPoint - runs every experiment of one point.
+ * replayTrace - replays a workload file through every algorithm.
+ * savePoint, readPoint - write and read back the results of a finished point.
+ * BENCH_MEMORY - memory laid out in an occupancy pattern for the benchmarks.
+ * fillMemory - lays out memory in a pattern.
+ * benchSearchArr, benchSmallest, benchBiggest, benchFirstHole, benchSmallestHole,
+   benchBiggestHole, benchAddToMem, benchIncrementTime - timed loops over one function.
+ * benchRun - picks the number of iterations of a benchmark.
+ * benchLine - prints one benchmark result.
+ * runBenchmarks - times the hot functions and every algorithm end to end.
+ * STRESS - a placement policy run as a real allocator shared by many threads.
+ * latencyBucket, bucketNs - log-linear histogram of operation times.
+ * lockRegion - takes a region lock, counting whether it was contended.
+ * stressAlloc, stressFree, stressFlush - allocate and free blocks of the shared arena.
+ * stressThread - thread issuing allocations and frees against the arena.
+ * stressPolicy - runs one policy under load and checks nothing was lost.
+ * runStress - runs every algorithm as a shared allocator and prints what it measured.
+ * main - populates the stream struct with random values for size and time,
+         then run 1000 experiments and print average for each algorithm,
+         for every point of the sweep grid.
+***************************************************************************/
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <climits>
+#include <string>
+#include <iomanip>
+#include <map>
+#include <unordered_map>
+#include <set>
+#include <vector>
+#include <utility>
+#include <queue>
+#include <functional>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+using namespace std;
+
+const int TRACE_WINDOW = 4096;                           // fewest tasks held in memory at a time while replaying a trace
+bool SCAN_MEM = false;                                  // use the bitmap scans of mem instead of the hole index
+#ifdef NO_METRICS
+#define METRIC(statement)                               // metrics compiled out
+#else
+#define METRIC(statement) statement
+#endif
+thread_local long long SEARCH_STEPS = 0;                // search work done by this thread, read by simulate
+struct TIMELINE;
+TIMELINE* TIMELINE_OUT = nullptr;                       // timeline being recorded, nullptr when off
+#ifdef NO_TIMELINE
+#define ON_TIMELINE(statement)                          // timeline compiled out
+#else
+#define ON_TIMELINE(statement) do { if (TIMELINE_OUT != nullptr) { statement; } } while (0)
+#endif
+/***************************************************************************
+ * struct RNG
+ * Description: random number stream of one experiment, xoshiro256++ run as
+ * RNG_LANES independent generators side by side. One step advances every lane
+ * with the same shifts and xors, so fill compiles to vector code and produces
+ * RNG_LANES 64 bit words per step. seedRng derives every lane from (seed, trial)
+ * with splitmix64, so a stream depends only on its seed and experiment number.
+ * Parameters:
+ * N/A
+**************************************************************************/
+const int RNG_LANES = 4;
+struct RNG
+{
+    uint64_t s[4][RNG_LANES];                         // xoshiro256 state, word w of lane l at s[w][l]
+    uint64_t spare[RNG_LANES];                        // words of the last step not handed out yet
+    int used = RNG_LANES;                             // words of spare already handed out
+    void step(uint64_t* out)
+    {
+        for(int l=0; l<RNG_LANES; l++)
+        {
+            uint64_t sum = s[0][l] + s[3][l];
+            out[l] = ((sum << 23) | (sum >> 41)) + s[0][l];
+            uint64_t t = s[1][l] << 17;
+            s[2][l] ^= s[0][l];
+            s[3][l] ^= s[1][l];
+            s[1][l] ^= s[2][l];
+            s[0][l] ^= s[3][l];
+            s[2][l] ^= t;
+            s[3][l] = (s[3][l] << 45) | (s[3][l] >> 19);
+        }
+    }
+    uint64_t operator()()
+    {
+        if (used == RNG_LANES)
+        {
+            step(spare);
+            used = 0;
+        }
+        return spare[used++];
+    }
+    void fill(uint64_t* out, int n)                   // n random words
+    {
+        int i = 0;
+        for(; i + RNG_LANES <= n; i += RNG_LANES)
+        {
+            step(out + i);
+        }
+        for(; i < n; i++)
+        {
+            out[i] = (*this)();
+        }
+    }
+};
+/***************************************************************************
+ * void seedRng(RNG& rng, uint64_t seed, uint64_t trial)
+ * Description: seeds a stream from a base seed and experiment number. The pair
+ * is the counter of a splitmix64 sequence whose outputs fill the lane states.
+ * Parameters:
+ * rng     O/P   RNG&       stream to seed
+ * seed    I/P   uint64_t   base seed
+ * trial   I/P   uint64_t   experiment number
+**************************************************************************/
+void seedRng(RNG& rng, uint64_t seed, uint64_t trial)
+{
+    uint64_t x = (seed << 32) ^ trial;
+    for(int w=0; w<4; w++)
+    {
+        for(int l=0; l<RNG_LANES; l++)
+        {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            rng.s[w][l] = z ^ (z >> 31);
+        }
+    }
+    rng.used = RNG_LANES;
+}
+/***************************************************************************
+ * struct ARENA
+ * Description: block of memory owned by one worker. Everything carved from it
+ * lives as long as the worker and is released with it in one piece.
+ * Parameters:
+ * N/A
+**************************************************************************/
+struct ARENA
+{
+    vector<char> block;                               // backing memory
+    size_t used = 0;                                  // bytes handed out so far
+};
+/***************************************************************************
+ * void* arenaAlloc(ARENA& arena, size_t bytes)
+ * Description: hands out the next 64 byte aligned piece of the arena.
+ * Parameters:
+ * arena   I/O   ARENA&   arena to carve from
+ * bytes   I/P   size_t   number of bytes needed
+**************************************************************************/
+void* arenaAlloc(ARENA& arena, size_t bytes)
+{
+    size_t start = (arena.used + 63) / 64 * 64;
+    arena.used = start + bytes;
+    return arena.block.data() + start;
+}
+/***************************************************************************
+ * struct STREAM
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: struct that defines the info stream, one contiguous column per
+ * field indexed by task number. When a trace is replayed the stream is a window
+ * of capacity tasks that readTasks moves on through the trace.
+ * Parameters:
+ * N/A
+**************************************************************************/
+const unsigned char QUEUED = 1;                       // status bit: the task has been placed in memory
+struct STREAM
+{
+    int count = 0;                                    // number of tasks in the stream
+    int capacity = 0;                                 // number of tasks the columns hold
+    long long first = 0;                              // task number of the first task in the window
+    int* size;                                        // holds the size of each task
+    int* time;                                        // holds the time of each task
+    int* oTime;                                       // holds the original time of each task
+    long long* arrive;                                // clock time at which the task arrives
+    long long* tTime;                                 // holds the time taken to process the task, arrival to release
+    int* location;                                    // location in memory
+    int* alloc;                                       // units reserved for the task, size rounded up by the policy
+    long long* due;                                   // clock time at which the task leaves memory
+    int* region;                                      // region the task prefers, -1 for none
+    unsigned char* status;                            // QUEUED bit of each task
+};
+/***************************************************************************
+ * void initStream(STREAM& arr, ARENA& arena, int count)
+ * Description: carves the stream columns for count tasks out of the arena, growing
+ * it only when it is too small, so a reused arena keeps its memory.
+ * Parameters:
+ * arr     O/P   STREAM&   info stream to set up
+ * arena   I/O   ARENA&    arena the columns live in
+ * count   I/P   int       number of tasks in the stream
+**************************************************************************/
+void initStream(STREAM& arr, ARENA& arena, int count)
+{
+    size_t bytes = 10 * (count * sizeof(long long) + 64);
+    if (arena.block.size() < bytes)
+    {
+        arena.block.assign(bytes, 0);
+    }
+    arena.used = 0;
+    arr.count = arr.capacity = count;
+    arr.first = 0;
+    arr.size = (int*)arenaAlloc(arena, count * sizeof(int));
+    arr.time = (int*)arenaAlloc(arena, count * sizeof(int));
+    arr.oTime = (int*)arenaAlloc(arena, count * sizeof(int));
+    arr.arrive = (long long*)arenaAlloc(arena, count * sizeof(long long));
+    arr.tTime = (long long*)arenaAlloc(arena, count * sizeof(long long));
+    arr.location = (int*)arenaAlloc(arena, count * sizeof(int));
+    arr.alloc = (int*)arenaAlloc(arena, count * sizeof(int));
+    arr.due = (long long*)arenaAlloc(arena, count * sizeof(long long));
+    arr.region = (int*)arenaAlloc(arena, count * sizeof(int));
+    arr.status = (unsigned char*)arenaAlloc(arena, count);
+}
+/***************************************************************************
+ * void rePROCESS(STREAM& arr)
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: resets info stream's elements to allow them to be processed again.
+ * Parameters:
+ * arr    I/O  STREAM&  info stream of tasks
+**************************************************************************/
+void rePROCESS(STREAM& arr)
+{
+    size_t n = arr.count;                               		// resets every task a column at a time
+    memcpy(arr.time, arr.oTime, n * sizeof(int));
+    memset(arr.tTime, 0, n * sizeof(long long));
+    memset(arr.location, -1, n * sizeof(int));
+    memset(arr.alloc, 0, n * sizeof(int));
+    memset(arr.due, 0, n * sizeof(long long));
+    memset(arr.status, 0, n);
+}
+/***************************************************************************
+ * struct TRACE
+ * Description: workload file replayed in place of a generated stream. Tasks are
+ * read a window at a time, so memory use does not depend on the trace length.
+ * A trace is either CSV, one "size,duration,arrival[,region]" task per line with
+ * lines that do not start with a digit skipped, or binary: the 8 bytes "MPTRACE1"
+ * followed by one TRACE_RECORD per task in native byte order. Tasks without a
+ * region are spread over the regions round robin.
+ * Parameters:
+ * N/A
+**************************************************************************/
+struct TRACE_RECORD
+{
+    int32_t size;                                     // units requested
+    int32_t time;                                     // ticks the task stays in memory
+    int64_t arrive;                                   // clock time at which the task arrives
+};
+const char TRACE_MAGIC[8] = {'M','P','T','R','A','C','E','1'};
+struct TRACE
+{
+    FILE* file = nullptr;                             // open trace file
+    bool binary = false;                              // binary records instead of CSV lines
+    long long read = 0;                               // tasks read so far
+    vector<TRACE_RECORD> chunk;                       // binary read buffer, one window long
+};
+/***************************************************************************
+ * bool openTrace(TRACE& trace, const char* path)
+ * Description: opens a trace file and works out its format.
+ * Parameters:
+ * trace   O/P   TRACE&        trace to open
+ * path    I/P   const char*   file name
+**************************************************************************/
+bool openTrace(TRACE& trace, const char* path)
+{
+    trace.file = fopen(path, "rb");
+    if (trace.file == nullptr)
+    {
+        return false;
+    }
+    char magic[8];
+    trace.binary = fread(magic, 1, 8, trace.file) == 8 && memcmp(magic, TRACE_MAGIC, 8) == 0;
+    return true;
+}
+/***************************************************************************
+ * void rewindTrace(TRACE& trace)
+ * Description: moves back to the first task so the trace can be replayed again.
+ * Parameters:
+ * trace   I/O   TRACE&   trace to rewind
+**************************************************************************/
+void rewindTrace(TRACE& trace)
+{
+    fseek(trace.file, trace.binary ? 8 : 0, SEEK_SET);
+    trace.read = 0;
+}
+/***************************************************************************
+ * bool readTasks(TRACE& trace, STREAM& arr, int from)
+ * Description: moves the window on to task from. The tasks from it on keep
+ * their state and slide to the front, and the rest of the window is filled
+ * with the next tasks of the trace. Returns false, leaving the window alone,
+ * once the trace is used up.
+ * Parameters:
+ * trace   I/O   TRACE&    trace to read from
+ * arr     I/O   STREAM&   window to fill
+ * from    I/P   int       first task of the window to keep, arr.count for none
+**************************************************************************/
+bool readTasks(TRACE& trace, STREAM& arr, int from)
+{
+    int c = getc(trace.file);                                                   // nothing left, leave the window alone
+    if (c == EOF)
+    {
+        return false;
+    }
+    ungetc(c, trace.file);
+    int kept = arr.count - from, count = kept;
+    memmove(arr.size, arr.size + from, kept * sizeof(int));
+    memmove(arr.time, arr.time + from, kept * sizeof(int));
+    memmove(arr.oTime, arr.oTime + from, kept * sizeof(int));
+    memmove(arr.arrive, arr.arrive + from, kept * sizeof(long long));
+    memmove(arr.tTime, arr.tTime + from, kept * sizeof(long long));
+    memmove(arr.location, arr.location + from, kept * sizeof(int));
+    memmove(arr.alloc, arr.alloc + from, kept * sizeof(int));
+    memmove(arr.due, arr.due + from, kept * sizeof(long long));
+    memmove(arr.region, arr.region + from, kept * sizeof(int));
+    memmove(arr.status, arr.status + from, kept);
+    if (trace.binary)
+    {
+        trace.chunk.resize(arr.capacity - kept);
+        int records = fread(trace.chunk.data(), sizeof(TRACE_RECORD), arr.capacity - kept, trace.file);
+        for(int i=0; i<records; i++, count++)
+        {
+            arr.size[count] = trace.chunk[i].size;
+            arr.oTime[count] = trace.chunk[i].time;
+            arr.arrive[count] = trace.chunk[i].arrive;
+            arr.region[count] = -1;
+        }
+    }
+    else
+    {
+        char line[256];
+        while (count < arr.capacity && fgets(line, sizeof(line), trace.file) != nullptr)
+        {
+            int fields = line[0] >= '0' && line[0] <= '9' ? sscanf(line, "%d,%d,%lld,%d", &arr.size[count],
+                         &arr.oTime[count], &arr.arrive[count], &arr.region[count]) : 0;
+            if (fields >= 3)
+            {
+                arr.region[count] = fields == 4 ? arr.region[count] : -1;
+                count++;
+            }
+        }
+    }
+    for(int i=kept; i<count; i++)                                               // same limits as generated tasks
+    {
+        if( arr.size[i] < 1 ) arr.size[i] = 1;
+        if( arr.oTime[i] < 1 ) arr.oTime[i] = 1;
+        arr.time[i] = arr.oTime[i];
+        arr.tTime[i] = 0;
+        arr.location[i] = -1;
+        arr.alloc[i] = 0;
+        arr.due[i] = 0;
+        arr.status[i] = 0;
+    }
+    arr.first = trace.read - kept;
+    arr.count = count;
+    trace.read += count - kept;
+    return true;
+}
+/***************************************************************************
+ * struct SNAPSHOT
+ * Description: byte buffer a checkpoint is built in or read back from. Values
+ * are kept in native byte order like binary traces, so a checkpoint resumes on
+ * the build that wrote it. Reading past the end sets bad and reads zeros.
+ * Parameters:
+ * N/A
+**************************************************************************/
+struct SNAPSHOT
+{
+    vector<char> data;                                // bytes written so far
+    size_t pos = 0;                                   // next byte to read
+    bool bad = false;                                 // a read ran past the end
+};
+/***************************************************************************
+ * void putBytes(SNAPSHOT& snap, const void* bytes, size_t n)
+ * void getBytes(SNAPSHOT& snap, void* bytes, size_t n)
+ * Description: appends n bytes to a snapshot, or reads the next n back.
+ * putValue and getValue do the same for one value of a plain type, putVector
+ * and getVector for a length and the elements of a vector.
+ * Parameters:
+ * snap    I/O   SNAPSHOT&   snapshot
+ * bytes   I/O   void*       bytes to write or read into
+ * n       I/P   size_t      number of bytes
+**************************************************************************/
+void putBytes(SNAPSHOT& snap, const void* bytes, size_t n)
+{
+    const char* from = (const char*)bytes;
+    snap.data.insert(snap.data.end(), from, from + n);
+}
+void getBytes(SNAPSHOT& snap, void* bytes, size_t n)
+{
+    if (snap.bad || snap.data.size() - snap.pos < n)
+    {
+        snap.bad = true;
+        memset(bytes, 0, n);
+        return;
+    }
+    memcpy(bytes, snap.data.data() + snap.pos, n);
+    snap.pos += n;
+}
+template <class T> void putValue(SNAPSHOT& snap, const T& value) { putBytes(snap, &value, sizeof(T)); }
+template <class T> void getValue(SNAPSHOT& snap, T& value) { getBytes(snap, &value, sizeof(T)); }
+template <class T> void putVector(SNAPSHOT& snap, const vector<T>& values)
+{
+    putValue(snap, (long long)values.size());
+    putBytes(snap, values.data(), values.size() * sizeof(T));
+}
+template <class T> void getVector(SNAPSHOT& snap, vector<T>& values)
+{
+    long long n = 0;
+    getValue(snap, n);
+    if (n < 0 || (size_t)n > (snap.data.size() - snap.pos) / sizeof(T))   // more than is left, damaged
+    {
+        snap.bad = true;
+        n = 0;
+    }
+    values.resize(n);
+    getBytes(snap, values.data(), n * sizeof(T));
+}
+/***************************************************************************
+ * struct CHECKPOINT
+ * Description: periodic checkpoints of a run, taken every "every" seconds
+ * without stopping the simulation. The simulation fills one buffer while a
+ * writer thread saves the other to path.tmp and renames it over path, so the
+ * file on disk is always a whole checkpoint. A checkpoint due while the writer
+ * is still busy is skipped rather than waited for. A checkpoint is
+ *   "MPCKPT04", the command line options, the number of finished points of the
+ *   grid and their results (see savePoint), then the progress of the point
+ *   being run: the experiments done with their metrics (see saveTrials), or
+ *   for a trace the algorithms done and the state of the running one (saveRun).
+ * Generated streams need no random number state, each is made again from
+ * (seed, trial).
+ * Parameters:
+ * N/A
+**************************************************************************/
+const char CHECKPOINT_MAGIC[8] = {'M','P','C','K','P','T','0','4'};
+const int PROGRESS_TRIALS = 1;                        // progress of a point of generated experiments
+const int PROGRESS_TRACE = 2;                         // progress of a trace replay
+struct CHECKPOINT
+{
+    string path;                                      // checkpoint file, empty when not checkpointing
+    double every = 60;                                // seconds between checkpoints
+    string command;                                   // options of the run, only the same run resumes
+    int points = 0;                                   // finished points of the grid
+    SNAPSHOT finished;                                // their results
+    SNAPSHOT context;                                 // trace replay progress, written in front of the run state
+    SNAPSHOT resume;                                  // checkpoint being resumed, emptied once used up
+    int resumePoints = 0;                             // finished points in resume
+    SNAPSHOT buffer[2];                               // filled by the simulation and saved by the writer in turn
+    int filling = 0;                                  // buffer the simulation fills
+    chrono::steady_clock::time_point last = chrono::steady_clock::now();   // when the last one was handed over
+    atomic<bool> pending{false};                      // the writer is saving the other buffer
+    bool stop = false;                                // the writer should exit
+    mutex lock;                                       // guards pending, stop and filling for the writer
+    condition_variable wake;                          // signals the writer
+    thread writer;                                    // runs writeCheckpoints
+    ~CHECKPOINT()
+    {
+        if (writer.joinable())
+        {
+            {
+                lock_guard<mutex> hold(lock);
+                stop = true;
+            }
+            wake.notify_one();
+            writer.join();
+        }
+    }
+};
+/***************************************************************************
+ * bool checkpointDue(CHECKPOINT& cp)
+ * Description: true when cp.every seconds have passed since the last checkpoint
+ * and the writer is free to take the next one.
+ * Parameters:
+ * cp   I/P   CHECKPOINT&   checkpoints of the run
+**************************************************************************/
+bool checkpointDue(CHECKPOINT& cp)
+{
+    return !cp.pending && chrono::duration<double>(chrono::steady_clock::now() - cp.last).count() >= cp.every;
+}
+/***************************************************************************
+ * SNAPSHOT& beginCheckpoint(CHECKPOINT& cp)
+ * Description: starts a checkpoint in the free buffer with the header and the
+ * results of the finished points. The caller adds the progress of the point
+ * being run and hands it over with commitCheckpoint.
+ * Parameters:
+ * cp   I/O   CHECKPOINT&   checkpoints of the run
+**************************************************************************/
+SNAPSHOT& beginCheckpoint(CHECKPOINT& cp)
+{
+    SNAPSHOT& out = cp.buffer[cp.filling];
+    out.data.clear();
+    putBytes(out, CHECKPOINT_MAGIC, 8);
+    putValue(out, (int)cp.command.size());
+    putBytes(out, cp.command.data(), cp.command.size());
+    putValue(out, cp.points);
+    putBytes(out, cp.finished.data.data(), cp.finished.data.size());
+    return out;
+}
+/***************************************************************************
+ * void commitCheckpoint(CHECKPOINT& cp)
+ * Description: hands the buffer just filled to the writer and switches the
+ * simulation to the other one.
+ * Parameters:
+ * cp   I/O   CHECKPOINT&   checkpoints of the run
+**************************************************************************/
+void commitCheckpoint(CHECKPOINT& cp)
+{
+    {
+        lock_guard<mutex> hold(cp.lock);
+        cp.filling = 1 - cp.filling;
+        cp.pending = true;
+    }
+    cp.wake.notify_one();
+    cp.last = chrono::steady_clock::now();
+}
+/***************************************************************************
+ * void writeCheckpoints(CHECKPOINT& cp)
+ * Description: writer thread. Saves each checkpoint it is handed to cp.path.tmp
+ * and renames it over cp.path, until told to stop.
+ * Parameters:
+ * cp   I/O   CHECKPOINT&   checkpoints of the run
+**************************************************************************/
+void writeCheckpoints(CHECKPOINT& cp)
+{
+    unique_lock<mutex> hold(cp.lock);
+    while (true)
+    {
+        while (!cp.pending && !cp.stop)
+        {
+            cp.wake.wait(hold);
+        }
+        if (!cp.pending)
+        {
+            return;
+        }
+        SNAPSHOT& out = cp.buffer[1 - cp.filling];
+        hold.unlock();
+        string temp = cp.path + ".tmp";
+        FILE* file = fopen(temp.c_str(), "wb");
+        bool ok = file != nullptr && fwrite(out.data.data(), 1, out.data.size(), file) == out.data.size();
+        ok = file != nullptr && fclose(file) == 0 && ok;
+        if (!ok || rename(temp.c_str(), cp.path.c_str()) != 0)
+        {
+            cerr << " cannot write checkpoint " << cp.path << endl;
+        }
+        hold.lock();
+        cp.pending = false;
+    }
+}
+/***************************************************************************
+ * bool readCheckpoint(CHECKPOINT& cp)
+ * Description: reads cp.path into cp.resume if it exists and checks that it was
+ * written by the same command. Returns false if it was not. Starts the writer.
+ * Parameters:
+ * cp   I/O   CHECKPOINT&   checkpoints of the run
+**************************************************************************/
+bool readCheckpoint(CHECKPOINT& cp)
+{
+    FILE* file = fopen(cp.path.c_str(), "rb");
+    if (file != nullptr)                                                        // an interrupted run to carry on
+    {
+        char block[1 << 16];
+        for(size_t n; (n = fread(block, 1, sizeof(block), file)) > 0; )
+        {
+            putBytes(cp.resume, block, n);
+        }
+        fclose(file);
+        char magic[8];
+        int length = 0;
+        getBytes(cp.resume, magic, 8);
+        getValue(cp.resume, length);
+        string command(max(length, 0), ' ');
+        getBytes(cp.resume, &command[0], command.size());
+        getValue(cp.resume, cp.resumePoints);
+        if (cp.resume.bad || memcmp(magic, CHECKPOINT_MAGIC, 8) != 0 || command != cp.command)
+        {
+            cerr << " checkpoint " << cp.path << " was not written by this command" << endl;
+            return false;
+        }
+        cerr << " resuming from " << cp.path << endl;
+    }
+    cp.writer = thread(writeCheckpoints, ref(cp));
+    return true;
+}
+/***************************************************************************
+ * void finishCheckpoints(CHECKPOINT& cp)
+ * Description: waits for the writer to finish and removes the checkpoint, the
+ * run it was for being complete.
+ * Parameters:
+ * cp   I/O   CHECKPOINT&   checkpoints of the run
+**************************************************************************/
+void finishCheckpoints(CHECKPOINT& cp)
+{
+    {
+        lock_guard<mutex> hold(cp.lock);
+        cp.stop = true;
+    }
+    cp.wake.notify_one();
+    cp.writer.join();
+    remove(cp.path.c_str());
+    remove((cp.path + ".tmp").c_str());
+}
+/***************************************************************************
+ * struct TIMELINE, TIMELINE_RING, TIMELINE_EVENT
+ * Description: optional timeline of every run. addToMem records placements,
+ * incrementTime records releases and every tick with the free units and holes
+ * of memory. Each thread writes its events into its own ring of TIMELINE_SLOTS
+ * with no lock: only it moves head and only the writer thread moves tail. The
+ * writer drains every ring to the file; a thread that finds its ring full
+ * waits for it, so no event is lost. Rings are handed to the next thread once
+ * their owner exits. The file is binary, "MPTLINE1" then TIMELINE_EVENT
+ * records in native byte order, or Chrome trace JSON when its name ends in
+ * .json: one process per run, each task an async slice from placement to
+ * release on the track of its region, and free units and holes as counters,
+ * one clock tick to the microsecond. Compaction moves are not recorded. When
+ * no timeline is asked for every hook is one pointer test, and NO_TIMELINE
+ * compiles them out.
+ * Parameters:
+ * N/A
+**************************************************************************/
+const char TIMELINE_MAGIC[8] = {'M','P','T','L','I','N','E','1'};
+const int TIMELINE_RUN = 0;                           // a run starts, trial in task and algorithm in location
+const int TIMELINE_PLACE = 1;                         // a task is placed
+const int TIMELINE_RELEASE = 2;                       // a task leaves memory
+const int TIMELINE_TICK = 3;                          // the clock moves on, step in task, free units and holes before it
+const int TIMELINE_SLOTS = 1 << 14;                   // events per ring, a power of two
+struct TIMELINE_EVENT
+{
+    int64_t time;                                     // clock time of the run
+    int64_t task;                                     // task number, trial of a run or step of a tick
+    int32_t location;                                 // first unit, free units at a tick or index into FITS of a run
+    int32_t units;                                    // units reserved, or holes at a tick
+    int32_t run;                                      // run the event belongs to
+    int16_t region;                                   // region, -1 for none
+    uint8_t kind;                                     // TIMELINE_RUN, _PLACE, _RELEASE or _TICK
+    uint8_t unused;
+};
+struct TIMELINE_RING
+{
+    alignas(64) atomic<uint64_t> head{0};             // events written by the owner
+    alignas(64) atomic<uint64_t> tail{0};             // events taken by the writer
+    atomic<bool> owned{false};                        // a live thread writes into it
+    long long stalls = 0;                             // times the owner found it full
+    TIMELINE_EVENT events[TIMELINE_SLOTS];
+};
+struct TIMELINE_LEASE                                 // gives a thread's ring back when the thread exits
+{
+    TIMELINE_RING* ring = nullptr;
+    int run = -1;                                     // run the thread is on
+    ~TIMELINE_LEASE()
+    {
+        if (ring != nullptr)
+        {
+            ring->owned = false;
+        }
+    }
+};
+thread_local TIMELINE_LEASE TIMELINE_THREAD;
+struct TIMELINE
+{
+    FILE* file = nullptr;                             // where the events go
+    bool json = false;                                // Chrome trace JSON instead of binary records
+    long long written = 0;                            // events written so far
+    deque<TIMELINE_RING> rings;                       // one per thread, never moved once made
+    mutex lock;                                       // guards rings while one is added
+    atomic<int> runs{0};                              // runs started so far
+    atomic<bool> stop{false};                         // the writer should drain and exit
+    thread writer;                                    // runs writeTimeline
+    ~TIMELINE()
+    {
+        if (writer.joinable())
+        {
+            stop = true;
+            writer.join();
+        }
+        TIMELINE_OUT = nullptr;
+        TIMELINE_THREAD.ring = nullptr;                                         // the rings go with the timeline
+    }
+};
+/***************************************************************************
+ * TIMELINE_RING& timelineRing()
+ * Description: ring of the calling thread, taking a free one or making one
+ * the first time the thread records an event.
+ * Parameters:
+ * N/A
+**************************************************************************/
+TIMELINE_RING& timelineRing()
+{
+    if (TIMELINE_THREAD.ring == nullptr)
+    {
+        TIMELINE& timeline = *TIMELINE_OUT;
+        lock_guard<mutex> hold(timeline.lock);
+        for(size_t i=0; i<timeline.rings.size() && TIMELINE_THREAD.ring == nullptr; i++)
+        {
+            bool owned = false;
+            if (timeline.rings[i].owned.compare_exchange_strong(owned, true))
+            {
+                TIMELINE_THREAD.ring = &timeline.rings[i];
+            }
+        }
+        if (TIMELINE_THREAD.ring == nullptr)
+        {
+            timeline.rings.emplace_back();
+            TIMELINE_THREAD.ring = &timeline.rings.back();
+            TIMELINE_THREAD.ring->owned = true;
+        }
+    }
+    return *TIMELINE_THREAD.ring;
+}
+/***************************************************************************
+ * void timelineEvent(int kind, long long time, long long task, int location, int units, int region)
+ * Description: records one event of the calling thread's run.
+ * Parameters:
+ * kind       I/P   int         TIMELINE_PLACE, _RELEASE or _TICK
+ * time       I/P   long long   clock time of the run
+ * task       I/P   long long   task number, or step of a tick
+ * location   I/P   int         first unit, or free units
+ * units      I/P   int         units reserved, or holes
+ * region     I/P   int         region, -1 for none
+**************************************************************************/
+void timelineEvent(int kind, long long time, long long task, int location, int units, int region)
+{
+    TIMELINE_RING& ring = timelineRing();
+    uint64_t head = ring.head.load(memory_order_relaxed);
+    while (head - ring.tail.load(memory_order_acquire) == TIMELINE_SLOTS)      // full, wait for the writer
+    {
+        ring.stalls++;
+        this_thread::yield();
+    }
+    TIMELINE_EVENT& event = ring.events[head & (TIMELINE_SLOTS - 1)];
+    event.time = time;
+    event.task = task;
+    event.location = location;
+    event.units = units;
+    event.run = TIMELINE_THREAD.run;
+    event.region = (int16_t)region;
+    event.kind = (uint8_t)kind;
+    event.unused = 0;
+    ring.head.store(head + 1, memory_order_release);
+}
+/***************************************************************************
+ * void timelineRun(int policy, long long trial)
+ * Description: starts a new run on the calling thread, the events it records
+ * from now on belong to it.
+ * Parameters:
+ * policy   I/P   int         algorithm, index into FITS
+ * trial    I/P   long long   experiment number
+**************************************************************************/
+void timelineRun(int policy, long long trial)
+{
+    TIMELINE_THREAD.run = TIMELINE_OUT->runs++;
+    timelineEvent(TIMELINE_RUN, 0, trial, policy, 0, -1);
+}
+/***************************************************************************
+ * void writeEvents(TIMELINE& timeline, const TIMELINE_EVENT events[], int n, const char* const names[])
+ * Description: writes n events to the timeline file in its format, binary
+ * records in one write.
+ * Parameters:
+ * timeline   I/O   TIMELINE&                timeline being written
+ * events     I/P   const TIMELINE_EVENT[]   events
+ * n          I/P   int                      number of events
+ * names      I/P   const char* const[]      names of the algorithms
+**************************************************************************/
+void writeEvents(TIMELINE& timeline, const TIMELINE_EVENT events[], int n, const char* const names[])
+{
+    if (!timeline.json)
+    {
+        fwrite(events, sizeof(TIMELINE_EVENT), n, timeline.file);
+        timeline.written += n;
+        return;
+    }
+    for(int i=0; i<n; i++)
+    {
+        const TIMELINE_EVENT& event = events[i];
+        FILE* out = timeline.file;
+        fputs(timeline.written++ > 0 ? ",\n" : "\n", out);
+        if (event.kind == TIMELINE_RUN)
+        {
+            fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s trial %lld\"}}",
+                    event.run, names[event.location], (long long)event.task);
+        }
+        else if (event.kind == TIMELINE_TICK)
+        {
+            fprintf(out, "{\"name\":\"memory\",\"ph\":\"C\",\"pid\":%d,\"ts\":%lld,\"args\":{\"free\":%d,\"holes\":%d}}",
+                    event.run, (long long)event.time, event.location, event.units);
+        }
+        else
+        {
+            fprintf(out, "{\"name\":\"task %lld\",\"cat\":\"region %d\",\"ph\":\"%s\",\"id\":%lld,\"pid\":%d,\"ts\":%lld,"
+                    "\"args\":{\"at\":%d,\"units\":%d}}", (long long)event.task, event.region,
+                    event.kind == TIMELINE_PLACE ? "b" : "e", (long long)event.task, event.run, (long long)event.time,
+                    event.location, event.units);
+        }
+    }
+}
+/***************************************************************************
+ * void writeTimeline(TIMELINE& timeline, const char* const names[])
+ * Description: writer thread. Drains every ring to the file, sleeping a
+ * millisecond whenever they are all empty, until told to stop; then drains
+ * them once more.
+ * Parameters:
+ * timeline   I/O   TIMELINE&             timeline being written
+ * names      I/P   const char* const[]   names of the algorithms
+**************************************************************************/
+void writeTimeline(TIMELINE& timeline, const char* const names[])
+{
+    vector<TIMELINE_RING*> rings;
+    for(bool last = false; !last; )
+    {
+        last = timeline.stop;                                                   // producers are done once stop is seen
+        {
+            lock_guard<mutex> hold(timeline.lock);
+            rings.clear();
+            for(size_t i=0; i<timeline.rings.size(); i++)
+            {
+                rings.push_back(&timeline.rings[i]);
+            }
+        }
+        bool idle = true;
+        for(size_t i=0; i<rings.size(); i++)
+        {
+            TIMELINE_RING& ring = *rings[i];
+            uint64_t tail = ring.tail.load(memory_order_relaxed);
+            uint64_t head = ring.head.load(memory_order_acquire);
+            while (tail != head)                                                // up to the end of the ring at a time
+            {
+                uint64_t end = min(head, (tail | (TIMELINE_SLOTS - 1)) + 1);
+                writeEvents(timeline, &ring.events[tail & (TIMELINE_SLOTS - 1)], (int)(end - tail), names);
+                tail = end;
+                ring.tail.store(tail, memory_order_release);
+                idle = false;
+            }
+        }
+        if (idle && !last)
+        {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+}
+/***************************************************************************
+ * bool startTimeline(TIMELINE& timeline, const string& path, const char* const names[])
+ * void finishTimeline(TIMELINE& timeline)
+ * Description: startTimeline opens the timeline file, writes its header and
+ * starts recording, returning false if the file cannot be made.
+ * finishTimeline stops recording once every event is written and closes it.
+ * Parameters:
+ * timeline   I/O   TIMELINE&             timeline to record
+ * path       I/P   const string&         file, JSON when it ends in .json
+ * names      I/P   const char* const[]   names of the algorithms
+**************************************************************************/
+bool startTimeline(TIMELINE& timeline, const string& path, const char* const names[])
+{
+    timeline.file = fopen(path.c_str(), "wb");
+    if (timeline.file == nullptr)
+    {
+        cerr << " cannot write timeline " << path << endl;
+        return false;
+    }
+    timeline.json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (timeline.json)
+    {
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", timeline.file);
+    }
+    else
+    {
+        fwrite(TIMELINE_MAGIC, 1, 8, timeline.file);
+    }
+    timeline.writer = thread(writeTimeline, ref(timeline), names);
+    TIMELINE_OUT = &timeline;
+    return true;
+}
+void finishTimeline(TIMELINE& timeline)
+{
+    timeline.stop = true;
+    timeline.writer.join();
+    TIMELINE_OUT = nullptr;
+    TIMELINE_THREAD.ring = nullptr;
+    long long stalls = 0;
+    for(size_t i=0; i<timeline.rings.size(); i++)
+    {
+        stalls += timeline.rings[i].stalls;
+    }
+    if (timeline.json)
+    {
+        fputs("\n]}\n", timeline.file);
+    }
+    fclose(timeline.file);
+    cerr << " timeline: " << timeline.written << " events";
+    if (stalls > 0)
+    {
+        cerr << ", threads waited " << stalls << " times for the writer";
+    }
+    cerr << endl;
+}
+/***************************************************************************
+ * struct RELEASE, EVENTS
+ * Description: min-heap of the extents resident in memory, keyed by the clock
+ * time at which each one is released. Each entry carries its own extent, so
+ * the stream slot of the task can be reused while it is still resident.
+ * clear empties the heap in O(1) and keeps its storage for the next run.
+ * extents exposes the heap array for compaction, which may change locations
+ * within a region but not their order.
+**************************************************************************/
+struct RELEASE
+{
+    long long due;                                    // clock time the extent is released
+    int location;                                     // first unit of the extent
+    int units;                                        // units reserved
+    int region;                                       // region the extent is in
+    bool operator>(const RELEASE& other) const
+    {
+        if (due != other.due)
+        {
+            return due > other.due;
+        }
+        return region != other.region ? region > other.region : location > other.location;
+    }
+};
+struct EVENTS : priority_queue<RELEASE, vector<RELEASE>, greater<RELEASE>>
+{
+    void clear() { c.clear(); }
+    vector<RELEASE>& extents() { return c; }
+};
+/***************************************************************************
+ * struct COUNTS
+ * Description: live counts kept by simulate as tasks are placed and released,
+ * so the loop never has to scan the stream or memory to know where it is.
+ * Tasks are only placed or rejected from the stream window, so every task has
+ * been queued once queued reaches the number of tasks seen, and memory is
+ * drained at lastDue.
+ * Parameters:
+ * N/A
+**************************************************************************/
+struct COUNTS
+{
+    long long queued = 0;                             // tasks placed in memory or rejected so far
+    long long resident = 0;                           // tasks in memory now
+    long long completed = 0;                          // tasks released from memory
+    long long lastDue = 0;                            // latest release time of any placed task
+    long long requested = 0;                          // units asked for by placed tasks
+    long long reserved = 0;                           // units reserved for them once rounded by the policy
+};
+/***************************************************************************
+ * struct HOLES
+ * Description: free-extent index of the memory array. Every hole is kept by
+ * address and by size, and a max tree over hole start addresses lets first-fit
+ * find the lowest hole of a given size without walking the holes below it.
+ * Parameters:
+ * N/A
+**************************************************************************/
+struct HOLES
+{
+    map<int,int> byAddr;                              // hole start -> hole length
+    set<pair<int,int>> bySize;                        // (hole length, hole start)
+    vector<int> tree;                                 // max hole length below each node, leaves are hole starts
+    int leaves = 0;                                   // number of leaves in tree
+    int size = 0;                                     // number of allocation units in memory
+    long long total = 0;                              // free units in all holes
+};
+/***************************************************************************
+ * void setStart(HOLES& holes, int addr, int len)
+ * Description: records a hole of length len starting at addr in the max tree (0 clears it).
+ * Parameters:
+ * holes   I/O   HOLES&   free-extent index
+ * addr    I/P   int      start address of the hole
+ * len     I/P   int      length of the hole
+**************************************************************************/
+void setStart(HOLES& holes, int addr, int len)
+{
+    int n = addr + holes.leaves;
+    holes.tree[n] = len;
+    for(n /= 2; n >= 1; n /= 2)                                                 // walk up to the root
+    {
+        holes.tree[n] = max(holes.tree[2*n], holes.tree[2*n+1]);
+    }
+}
+/***************************************************************************
+ * void addHole(HOLES& holes, int addr, int len)
+ * Description: inserts a hole into every view of the index.
+ * Parameters:
+ * holes   I/O   HOLES&   free-extent index
+ * addr    I/P   int      start address of the hole
+ * len     I/P   int      length of the hole
+**************************************************************************/
+void addHole(HOLES& holes, int addr, int len)
+{
+    holes.byAddr[addr] = len;
+    holes.total += len;
+    holes.bySize.insert(make_pair(len, addr));
+    setStart(holes, addr, len);
+}
+/***************************************************************************
+ * void dropHole(HOLES& holes, int addr, int len)
+ * Description: removes a hole from every view of the index.
+ * Parameters:
+ * holes   I/O   HOLES&   free-extent index
+ * addr    I/P   int      start address of the hole
+ * len     I/P   int      length of the hole
+**************************************************************************/
+void dropHole(HOLES& holes, int addr, int len)
+{
+    holes.byAddr.erase(addr);
+    holes.total -= len;
+    holes.bySize.erase(make_pair(len, addr));
+    setStart(holes, addr, 0);
+}
+/***************************************************************************
+ * void initHoles(HOLES& holes, int memSize)
+ * Description: resets the index to a single hole covering all of memory.
+ * Parameters:
+ * holes     O/P   HOLES&   free-extent index
+ * memSize   I/P   int      number of allocation units in memory
+**************************************************************************/
+void initHoles(HOLES& holes, int memSize)
+{
+    holes.byAddr.clear();
+    holes.bySize.clear();
+    holes.total = 0;
+    holes.size = memSize;
+    holes.leaves = 1;
+    while (holes.leaves < memSize)
+    {
+        holes.leaves *= 2;
+    }
+    holes.tree.assign(2 * holes.leaves, 0);
+    addHole(holes, 0, memSize);
+}
+/***************************************************************************
+ * void takeHole(HOLES& holes, int put, int size)
+ * Description: removes [put, put+size) from the hole that contains it, keeping
+ * whatever is left on either side as smaller holes.
+ * Parameters:
+ * holes   I/O   HOLES&   free-extent index
+ * put     I/P   int      start address of the placed task
+ * size    I/P   int      size of the placed task
+**************************************************************************/
+void takeHole(HOLES& holes, int put, int size)
+{
+    map<int,int>::iterator it = prev(holes.byAddr.upper_bound(put));            // hole containing put
+    int start = it->first, len = it->second;
+    dropHole(holes, start, len);
+    if (put > start)                                                            // space left in front
+    {
+        addHole(holes, start, put - start);
+    }
+    if (start + len > put + size)                                               // space left behind
+    {
+        addHole(holes, put + size, start + len - put - size);
+    }
+}
+/***************************************************************************
+ * void giveHole(HOLES& holes, int addr, int size)
+ * Description: returns a released extent to the index, merging it with the
+ * holes directly before and after it.
+ * Parameters:
+ * holes   I/O   HOLES&   free-extent index
+ * addr    I/P   int      start address of the released task
+ * size    I/P   int      size of the released task
+**************************************************************************/
+void giveHole(HOLES& holes, int addr, int size)
+{
+    int start = addr, end = addr + size;
+    map<int,int>::iterator next = holes.byAddr.lower_bound(addr);
+    if (next != holes.byAddr.end() && next->first == end)                      // merge with the hole behind
+    {
+        end += next->second;
+        dropHole(holes, next->first, next->second);
+    }
+    next = holes.byAddr.lower_bound(addr);
+    if (next != holes.byAddr.begin())
+    {
+        map<int,int>::iterator before = prev(next);
+        if (before->first + before->second == start)                            // merge with the hole in front
+        {
+            start = before->first;
+            dropHole(holes, before->first, before->second);
+        }
+    }
+    addHole(holes, start, end - start);
+}
+/***************************************************************************
+ * int lowestStart(HOLES& holes, int node, int nodeLo, int nodeHi, int lo, int hi, int tSize)
+ * Description: finds the lowest hole start in [lo, hi) whose hole holds tSize units.
+ * Parameters:
+ * holes    I/P   HOLES&   free-extent index
+ * node     I/P   int      current tree node covering [nodeLo, nodeHi)
+ * lo, hi   I/P   int      address range to search
+ * tSize    I/P   int      size of the task
+**************************************************************************/
+int lowestStart(HOLES& holes, int node, int nodeLo, int nodeHi, int lo, int hi, int tSize)
+{
+    METRIC(SEARCH_STEPS++);
+    if (nodeHi <= lo || hi <= nodeLo || holes.tree[node] < tSize)               // nothing usable below this node
+    {
+        return -1;
+    }
+    if (nodeHi - nodeLo == 1)
+    {
+        return nodeLo;
+    }
+    int mid = (nodeLo + nodeHi) / 2;
+    int found = lowestStart(holes, 2*node, nodeLo, mid, lo, hi, tSize);
+    if (found < 0)
+    {
+        found = lowestStart(holes, 2*node+1, mid, nodeHi, lo, hi, tSize);
+    }
+    return found;
+}
+/***************************************************************************
+ * int firstHole(HOLES& holes, int startPos, int tSize)
+ * Description: index version of searchArr, returns the same position in logarithmic time.
+ * Parameters:
+ * holes     I/P   HOLES&   free-extent index
+ * startPos  I/P   int      Holds the start position of the search
+ * tSize     I/P   int      Holds the size of the task
+**************************************************************************/
+int firstHole(HOLES& holes, int startPos, int tSize)
+{
+    map<int,int>::iterator it = holes.byAddr.upper_bound(startPos);
+    if (it != holes.byAddr.begin())                                             // hole containing startPos
+    {
+        map<int,int>::iterator in = prev(it);
+        if (in->first + in->second - startPos >= tSize)
+        {
+            return startPos;
+        }
+    }
+    int put = lowestStart(holes, 1, 0, holes.leaves, startPos + 1, holes.leaves, tSize);
+    if (put < 0)                                                                // returns to the beginning
+    {
+        put = lowestStart(holes, 1, 0, holes.leaves, 0, startPos, tSize);
+    }
+    return put;
+}
+/***************************************************************************
+ * void smallestHole(HOLES& holes, int& index, int& indexSize, int sizeReq)
+ * Description: index version of smallest, the smallest hole that fits with the lowest address.
+ * Parameters:
+ * holes       I/P  HOLES&   free-extent index
+ * index       O/P  int&     will hold the value of the smallest memory block
+ * indexSize   O/P  int&     holds the value of the smallest memory block
+ * sizeReq     I/P  int      holds the value of the space needed for the task
+**************************************************************************/
+void smallestHole(HOLES& holes, int& index, int& indexSize, int sizeReq)
+{
+    METRIC(SEARCH_STEPS++);
+    index = -1, indexSize = holes.size + 1;
+    set<pair<int,int>>::iterator it = holes.bySize.lower_bound(make_pair(sizeReq, -1));
+    if (it != holes.bySize.end())
+    {
+        indexSize = it->first;
+        index = it->second;
+    }
+}
+/***************************************************************************
+ * void biggestHole(HOLES& holes, int& index, int& indexSize, int sizeReq)
+ * Description: index version of biggest, the biggest hole with the lowest address.
+ * Parameters:
+ * holes       I/P  HOLES&   free-extent index
+ * index       O/P  int&     will hold the value of the largest memory block
+ * indexSize   O/P  int&     holds the value of the largest memory block
+ * sizeReq     I/P  int      holds the value of the space needed for the task
+**************************************************************************/
+void biggestHole(HOLES& holes, int& index, int& indexSize, int sizeReq)
+{
+    METRIC(SEARCH_STEPS++);
+    index = -1, indexSize = 0;
+    if (holes.bySize.empty() || holes.bySize.rbegin()->first < sizeReq)
+    {
+        return;
+    }
+    set<pair<int,int>>::iterator it = holes.bySize.lower_bound(make_pair(holes.bySize.rbegin()->first, -1));
+    indexSize = it->first;
+    index = it->second;
+}
+/***************************************************************************
+ * struct MEMMAP
+ * Description: the simulated memory, one occupancy bit per allocation unit and
+ * the owning task recorded only at the start of each extent. The bits past the
+ * end of memory in the last word are kept set so searches never run off it.
+ * Parameters:
+ * N/A
+**************************************************************************/
+struct MEMMAP
+{
+    vector<uint64_t> bits;                            // bit i set when unit i is occupied
+    unordered_map<int,long long> owner;               // extent start -> task number
+    int size = 0;                                     // number of allocation units in memory
+};
+/***************************************************************************
+ * void initMem(MEMMAP& mem, int memSize)
+ * Description: clears the memory map to memSize free units.
+ * Parameters:
+ * mem       O/P   MEMMAP&   memory map
+ * memSize   I/P   int       number of allocation units in memory
+**************************************************************************/
+void initMem(MEMMAP& mem, int memSize)
+{
+    mem.bits.assign(memSize / 64 + 1, 0);
+    mem.bits.back() = ~0ULL << (memSize % 64);                                  // padding past the end is occupied
+    mem.owner.clear();
+    mem.size = memSize;
+}
+/***************************************************************************
+ * void setUnits(MEMMAP& mem, int start, int len, bool used)
+ * Description: marks units [start, start+len) occupied or free a word at a time.
+ * Parameters:
+ * mem     I/O   MEMMAP&   memory map
+ * start   I/P   int       first unit
+ * len     I/P   int       number of units
+ * used    I/P   bool      true to occupy, false to free
+**************************************************************************/
+void setUnits(MEMMAP& mem, int start, int len, bool used)
+{
+    int end = start + len;
+    while (start < end)
+    {
+        int bit = start % 64;
+        int count = min(64 - bit, end - start);
+        uint64_t mask = (count == 64 ? ~0ULL : ((1ULL << count) - 1)) << bit;
+        if (used)
+        {
+            mem.bits[start / 64] |= mask;
+        }
+        else
+        {
+            mem.bits[start / 64] &= ~mask;
+        }
+        start += count;
+    }
+}
+/***************************************************************************
+ * size_t skipWords(MEMMAP& mem, size_t word, uint64_t value, size_t end)
+ * Description: returns the first word at or after word that is not equal to value,
+ * or end if every word before end is, four words per compare with AVX2 and one
+ * at a time otherwise. The padding word at the end is never all free, so a
+ * search for a non-free word always stops.
+ * Parameters:
+ * mem     I/P   MEMMAP&    memory map
+ * word    I/P   size_t     first word to look at
+ * value   I/P   uint64_t   word value to skip (0 or all ones)
+ * end     I/P   size_t     word to stop at, at most the number of words
+**************************************************************************/
+size_t skipWords(MEMMAP& mem, size_t word, uint64_t value, size_t end)
+{
+    size_t words = end;
+#ifdef __AVX2__
+    __m256i match = _mm256_set1_epi64x((long long)value);
+    for(; word + 4 <= words; word += 4)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i*)&mem.bits[word]);
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(block, match)) != -1)       // some word differs
+        {
+            break;
+        }
+    }
+#endif
+    while (word < words && mem.bits[word] == value)
+    {
+        word++;
+    }
+    return word;
+}
+/***************************************************************************
+ * bool nextHole(MEMMAP& mem, int from, int& start, int& len, int need)
+ * Description: finds the next run of free units starting at or after from.
+ * The run starts at the first clear bit and ends at the next set bit. The run
+ * is only measured until it is known to hold need units, so a search that just
+ * needs room does not walk the rest of a long hole; len is then need or more
+ * but may fall short of the hole. INT_MAX measures every hole in full.
+ * Parameters:
+ * mem     I/P   MEMMAP&   memory map
+ * from    I/P   int       first unit to look at
+ * start   O/P   int&      first unit of the hole
+ * len     O/P   int&      number of units in the hole, at least need when it holds them
+ * need    I/P   int       units after which the hole need not be measured
+**************************************************************************/
+bool nextHole(MEMMAP& mem, int from, int& start, int& len, int need)
+{
+    METRIC(SEARCH_STEPS++);
+    if (from >= mem.size)
+    {
+        return false;
+    }
+    size_t word = from / 64;
+    uint64_t w = mem.bits[word] | ((1ULL << (from % 64)) - 1);                  // units before from count as occupied
+    if (w == ~0ULL)
+    {
+        word = skipWords(mem, word + 1, ~0ULL, mem.bits.size());
+        if (word == mem.bits.size())
+        {
+            return false;
+        }
+        w = mem.bits[word];
+    }
+    start = word * 64 + __builtin_ctzll(~w);
+    w = mem.bits[word] & (~0ULL << (start % 64));                              // units before start count as free
+    if (w == 0)
+    {
+        size_t end = min(mem.bits.size(), ((size_t)start + need + 63) / 64);   // the words that hold need units
+        word = skipWords(mem, word + 1, 0, end);
+        if (word >= end)                                                        // free up to word, which is enough
+        {
+            len = word * 64 - start;
+            return true;
+        }
+        w = mem.bits[word];
+    }
+    len = word * 64 + __builtin_ctzll(w) - start;
+    return true;
+}
+/***************************************************************************
+ * int searchArr(MEMMAP& mem, int startPos,  int tSize)
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: search array used to search for specific tasks to place in memory.
+ * Walks the holes of the memory map instead of testing every unit.
+ * Parameters:
+ * mem       I/P    MEMMAP&      The memory map
+ * startPos  I/P    int          Holds the start position of the dynamic array
+ * tSize     I/P    int          Holds the size of the task
+**************************************************************************/
+int searchArr(MEMMAP& mem, int startPos,  int tSize)
+{
+    int start, len;
+    for(int i = startPos; nextHole(mem, i, start, len, tSize); i = start + len)   // search from current index
+    {
+        if (len >= tSize)
+        {
+            return start;
+        }
+    }
+    for(int i = 0; nextHole(mem, i, start, len, tSize) && start < startPos; i = start + len)   // returns to the beginning
+    {
+        if (len >= tSize)
+        {
+            return start;
+        }
+    }
+    return -1;
+}
+/***************************************************************************
+ * struct REGION, MEMORY
+ * Description: memory split into count regions, pools that share nothing. Each
+ * region has its own memory map and hole index, with addresses counted from its
+ * start, and simulate gives each its own instance of the placement policy. After
+ * every change a region publishes its free units, holes and fragmentation into
+ * the totals of MEMORY. When tracked it also publishes its room, the biggest
+ * reservation its policy serves now, into a max tree with one leaf per region.
+ * So no step looks at every region.
+ * Parameters:
+ * N/A
+**************************************************************************/
+struct REGION
+{
+    MEMMAP mem;                                       // memory map of the region
+    HOLES holes;                                      // free-extent index of mem
+    long long free = 0;                               // free units last published
+    long long holeCount = 0;                          // holes last published
+    double external = 0;                              // external fragmentation last published
+    int room = 0;                                     // room last published
+};
+struct MEMORY
+{
+    vector<REGION> region;                            // regions, the first count are in use
+    int count = 1;                                    // number of regions
+    long long size = 0;                               // units in all regions
+    long long free = 0;                               // free units in all regions
+    long long holes = 0;                              // holes in all regions
+    double external = 0;                              // sum of the external fragmentation of the regions
+    bool tracked = false;                             // keep rooms up to date, the scheduler or spilling reads it
+    HOLES rooms;                                      // max tree of the room of each region, leaves are regions
+};
+/***************************************************************************
+ * void initMemory(MEMORY& memory, int memSize, int count)
+ * Description: splits memSize units into count regions as equal as they can be,
+ * the first ones one unit bigger, and clears them. Nothing is published yet.
+ * Parameters:
+ * memory    O/P   MEMORY&   memory to set up
+ * memSize   I/P   int       number of allocation units in all regions
+ * count     I/P   int       number of regions, at most memSize
+**************************************************************************/
+void initMemory(MEMORY& memory, int memSize, int count)
+{
+    if ((int)memory.region.size() < count)
+    {
+        memory.region.resize(count);
+    }
+    memory.count = count;
+    memory.size = memSize;
+    memory.free = memory.holes = 0;
+    memory.external = 0;
+    memory.tracked = false;
+    for(int r=0; r<count; r++)
+    {
+        REGION& region = memory.region[r];
+        int size = memSize / count + (r < memSize % count ? 1 : 0);
+        initMem(region.mem, size);
+        initHoles(region.holes, size);
+        region.free = region.holeCount = 0;
+        region.external = 0;
+        region.room = 0;
+    }
+    memory.rooms.leaves = 1;
+    while (memory.rooms.leaves < count)
+    {
+        memory.rooms.leaves *= 2;
+    }
+    memory.rooms.tree.assign(2 * memory.rooms.leaves, 0);
+}
+/***************************************************************************
+ * int homeOf(const STREAM& arr, int task, int count)
+ * Description: region out of count that a task prefers. Tasks without one are
+ * spread round robin by task number.
+ * Parameters:
+ * arr     I/P   const STREAM&   info stream of tasks
+ * task    I/P   int             index of the task in the stream
+ * count   I/P   int             number of regions
+**************************************************************************/
+inline int homeOf(const STREAM& arr, int task, int count)
+{
+    if (count == 1)
+    {
+        return 0;
+    }
+    int r = arr.region[task];
+    return r < 0 ? (int)((arr.first + task) % count) : r % count;
+}
+/***************************************************************************
+ * void touchRegion(MEMORY& memory, POLICY& policy, int r)
+ * Description: publishes the state of region r after it changed, replacing what
+ * it published last in the totals and, when tracked, in the room tree.
+ * Parameters:
+ * memory   I/O   MEMORY&   partitioned memory
+ * policy   I/O   POLICY&   placement policy of the region
+ * r        I/P   int       region that changed
+**************************************************************************/
+template <class POLICY>
+void touchRegion(MEMORY& memory, POLICY& policy, int r)
+{
+    REGION& region = memory.region[r];
+    HOLES& holes = region.holes;
+    double external = holes.total > 0 ? 1 - (double)holes.bySize.rbegin()->first / holes.total : 0;
+    memory.free += holes.total - region.free;
+    memory.holes += (long long)holes.byAddr.size() - region.holeCount;
+    memory.external += external - region.external;
+    region.free = holes.total;
+    region.holeCount = holes.byAddr.size();
+    region.external = external;
+    if (memory.tracked)
+    {
+        region.room = policy.largest(region.mem, holes);
+        setStart(memory.rooms, r, region.room);
+    }
+}
+/***************************************************************************
+ * void addToMem(MEMMAP& mem, EVENTS& events, STREAM& arr, int task, int put, int units, long long now, int region)
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: Adds tasks to the memory and schedules their release. The units
+ * themselves are reserved by the placement policy.
+ * Parameters:
+ * mem         I/O   MEMMAP&      holds the memory map
+ * events      I/O   EVENTS&      release queue of resident tasks
+ * arr         I/O   STREAM&      info stream of tasks
+ * task        I/P   int          index of the task that needs to be placed in memory
+ * put         I/P   int          index of the value that needs to be placed in memory
+ * units       I/P   int          units reserved for the task
+ * now         I/P   long long    current clock time
+ * region      I/P   int          region mem belongs to
+**************************************************************************/
+void addToMem(MEMMAP& mem, EVENTS& events, STREAM& arr, int task, int put, int units, long long now, int region)
+{
+    mem.owner[put] = arr.first + task;              			// adds specific tasks to memory
+    arr.status[task] |= QUEUED;
+    arr.location[task] = put;
+    arr.alloc[task] = units;
+    arr.due[task] = now + arr.time[task];
+    arr.tTime[task] = arr.due[task] - arr.arrive[task];
+    RELEASE release = {arr.due[task], put, units, region};
+    events.push(release);
+    ON_TIMELINE(timelineEvent(TIMELINE_PLACE, now, arr.first + task, put, units, region));
+}
+/***************************************************************************
+ * long long nextRelease(EVENTS& events, long long now)
+ * Description: number of ticks until the next resident task leaves memory, or
+ * LLONG_MAX when memory is empty. Nothing can be placed before then, so the
+ * clock can jump straight to it.
+ * Parameters:
+ * events   I/P   EVENTS&   release queue of resident tasks
+ * now      I/P   long long current clock time
+**************************************************************************/
+long long nextRelease(EVENTS& events, long long now)
+{
+    if (events.empty())
+    {
+        return LLONG_MAX;
+    }
+    return events.top().due - now;
+}
+/***************************************************************************
+ * int incrementTime(MEMORY& memory, EVENTS& events, POLICY policy[], long long& totalTime, long long step)
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: This is the scheduling function which will output total time taken for each algorithm.
+ * Moves the clock forward by step ticks and hands every task that is due by then
+ * back to the placement policy of its region. Returns the number of tasks released.
+ * Parameters:
+ * memory     I/O       MEMORY&      regions of memory
+ * events     I/O       EVENTS&      release queue of resident tasks
+ * policy     I/O       POLICY[]     placement policy of each region, the units go back to
+ * totalTime  O/P       long long&   total time value
+ * step       I/P       long long    number of ticks to move forward
+**************************************************************************/
+template <class POLICY>
+int incrementTime(MEMORY& memory, EVENTS& events, POLICY policy[], long long& totalTime, long long step)
+{
+    int released = 0;
+    ON_TIMELINE(timelineEvent(TIMELINE_TICK, totalTime, step, (int)memory.free, (int)memory.holes, -1));
+    totalTime += step;
+    while (!events.empty() && events.top().due <= totalTime)                // Task completed: Remove from memory
+    {
+        RELEASE done = events.top();
+        events.pop();
+        REGION& region = memory.region[done.region];
+        ON_TIMELINE(timelineEvent(TIMELINE_RELEASE, done.due, region.mem.owner[done.location], done.location, done.units,
+                                  done.region));
+        region.mem.owner.erase(done.location);
+        policy[done.region].released(region.mem, region.holes, done.location, done.units);
+        touchRegion(memory, policy[done.region], done.region);
+        released++;
+    }
+    return released;
+}
+/***************************************************************************
+ * void timelineResident(MEMORY& memory, EVENTS& events)
+ * Description: records the release of every task still in memory when a run
+ * ends, at the time it is due, so every placement on the timeline is closed.
+ * Parameters:
+ * memory   I/P   MEMORY&   regions of memory
+ * events   I/P   EVENTS&   release queue of resident tasks
+**************************************************************************/
+void timelineResident(MEMORY& memory, EVENTS& events)
+{
+    vector<RELEASE>& resident = events.extents();
+    for(size_t e=0; e<resident.size(); e++)
+    {
+        timelineEvent(TIMELINE_RELEASE, resident[e].due, memory.region[resident[e].region].mem.owner[resident[e].location],
+                      resident[e].location, resident[e].units, resident[e].region);
+    }
+}
+/***************************************************************************
+ * void biggest(MEMMAP& mem, int& index, int& indexSize, int sizeReq)
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: finds the biggest memory block, this is used for the worst case algorithm.
+ * Parameters:
+ * mem         I/P  MEMMAP&      memory map
+ * index       O/P  int&         will hold the value of the largest memory block
+ * indexSize   I/P  int&         holds the value of the largest memory block
+ * sizeReq     I/P  int          holds the value of the space needed for the task
+**************************************************************************/
+void biggest(MEMMAP& mem, int& index, int& indexSize, int sizeReq)
+{
+    index = -1, indexSize = 0;
+    int start, len;
+    for(int i = 0; nextHole(mem, i, start, len, INT_MAX); i = start + len)      // go through the holes in memory
+    {
+        if ( len > indexSize && len >= sizeReq )                                // Check if counter is greater than the previous biggest
+        {
+            indexSize = len;                                                    // Update previous biggest memory value
+            index = start;
+        }
+    }
+}
+/***************************************************************************
+ * void smallest(MEMMAP& mem, int& index, int& indexSize, int sizeReq)
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: finds the smallest memory block needed in the bestfit algorithm.
+ * Parameters:
+ * mem         I/P  MEMMAP&      memory map
+ * index       O/P  int&         will hold the value of the smallest memory block
+ * indexSize   I/P  int&         holds the value of the smallest memory block
+ * sizeReq     I/P  int          holds the value of the space needed for the task
+**************************************************************************/
+void smallest(MEMMAP& mem, int& index, int& indexSize, int sizeReq)
+{
+    indexSize = mem.size + 1, index = -1;
+    int start, len;
+    for(int i = 0; nextHole(mem, i, start, len, INT_MAX); i = start + len)      // go through the holes in memory
+    {
+        if (len < indexSize && len >= sizeReq )                                 // check if value is smaller than previous
+        {
+            indexSize = len;                                                    // Update previous smallest
+            index = start;
+        }
+    }
+}
+/***************************************************************************
+ * void takeUnits(MEMMAP& mem, HOLES& holes, int put, int units)
+ * Description: reserves [put, put+units) in the memory map and the hole index.
+ * Parameters:
+ * mem     I/O   MEMMAP&   memory map
+ * holes   I/O   HOLES&    free-extent index of mem
+ * put     I/P   int       first unit
+ * units   I/P   int       number of units
+**************************************************************************/
+void takeUnits(MEMMAP& mem, HOLES& holes, int put, int units)
+{
+    setUnits(mem, put, units, true);
+    takeHole(holes, put, units);
+}
+/***************************************************************************
+ * void freeUnits(MEMMAP& mem, HOLES& holes, int put, int units)
+ * Description: frees [put, put+units) in the memory map and the hole index.
+ * Parameters:
+ * mem     I/O   MEMMAP&   memory map
+ * holes   I/O   HOLES&    free-extent index of mem
+ * put     I/P   int       first unit
+ * units   I/P   int       number of units
+**************************************************************************/
+void freeUnits(MEMMAP& mem, HOLES& holes, int put, int units)
+{
+    setUnits(mem, put, units, false);
+    giveHole(holes, put, units);
+}
+/***************************************************************************
+ * struct FIT_POLICY, BEST_FIT, FIRST_FIT, NEXT_FIT, WORST_FIT
+ * Description: placement policies for simulate. A policy is any struct with
+ *   void init(int memSize)
+ *       sets the policy up for a memory of memSize free units
+ *   int round(int size)
+ *       units reserved for a task of size units
+ *   int find(MEMMAP& mem, HOLES& holes, int units, bool scan)
+ *       returns where the reservation goes, or -1 if it does not fit yet
+ *   void placed(MEMMAP& mem, HOLES& holes, int put, int units)
+ *       reserves the units find chose
+ *   void released(MEMMAP& mem, HOLES& holes, int put, int units)
+ *       takes the units of a finished task back
+ *   bool movable(MEMMAP& mem, HOLES& holes)
+ *       gets ready for compaction, false if the policy's blocks cannot move
+ *   int largest(MEMMAP& mem, HOLES& holes)
+ *       biggest reservation find would serve now, asked by the scheduler
+ *   int limit(HOLES& holes)
+ *       biggest reservation find could ever serve, with the region empty
+ *   void save(SNAPSHOT& out), void load(SNAPSHOT& in)
+ *       write and read back what the policy keeps besides the memory map
+ * FIT_POLICY supplies the plain versions of everything but find. simulate is
+ * instantiated per policy, so every call is inlined, and keeps one instance of
+ * the policy per region of memory.
+ * Parameters:
+ * N/A
+**************************************************************************/
+struct FIT_POLICY
+{
+    void init(int) {}
+    int round(int size) { return size; }
+    void placed(MEMMAP& mem, HOLES& holes, int put, int units) { takeUnits(mem, holes, put, units); }
+    void released(MEMMAP& mem, HOLES& holes, int put, int units) { freeUnits(mem, holes, put, units); }
+    bool movable(MEMMAP&, HOLES&) { return true; }
+    int largest(MEMMAP&, HOLES& holes) { return holes.bySize.empty() ? 0 : holes.bySize.rbegin()->first; }
+    int limit(HOLES& holes) { return holes.size; }
+    void save(SNAPSHOT&) {}
+    void load(SNAPSHOT&) {}
+};
+struct BEST_FIT : FIT_POLICY                          // smallest hole that fits
+{
+    int find(MEMMAP& mem, HOLES& holes, int units, bool scan)
+    {
+        int index, indexSize;
+        if (scan)
+        {
+            smallest(mem, index, indexSize, units);
+        }
+        else
+        {
+            smallestHole(holes, index, indexSize, units);
+        }
+        return index;
+    }
+};
+struct FIRST_FIT : FIT_POLICY                         // lowest hole that fits
+{
+    int find(MEMMAP& mem, HOLES& holes, int units, bool scan)
+    {
+        return scan ? searchArr(mem, 0, units) : firstHole(holes, 0, units);
+    }
+};
+struct NEXT_FIT : FIT_POLICY                          // first hole that fits after the last placement
+{
+    int last = 0;
+    int find(MEMMAP& mem, HOLES& holes, int units, bool scan)
+    {
+        return scan ? searchArr(mem, last, units) : firstHole(holes, last, units);
+    }
+    void placed(MEMMAP& mem, HOLES& holes, int put, int units)
+    {
+        last = put;
+        takeUnits(mem, holes, put, units);
+    }
+    void save(SNAPSHOT& out) { putValue(out, last); }
+    void load(SNAPSHOT& in) { getValue(in, last); }
+};
+struct WORST_FIT : FIT_POLICY                         // biggest hole
+{
+    int find(MEMMAP& mem, HOLES& holes, int units, bool scan)
+    {
+        int index, indexSize;
+        if (scan)
+        {
+            biggest(mem, index, indexSize, units);
+        }
+        else
+        {
+            biggestHole(holes, index, indexSize, units);
+        }
+        return index;
+    }
+};
+/***************************************************************************
+ * struct BUDDY
+ * Description: binary buddy allocator. Requests are rounded up to a power of
+ * two and served from a free list per block order, splitting bigger blocks as
+ * needed. Released blocks merge with their buddy while it is free. Memory that
+ * is not a power of two is split into the largest aligned blocks that fit
+ * (56 = 32 + 16 + 8). Their buddies lie past the end and are never free, so
+ * the first block is the biggest there is, and a task rounded past it is
+ * rejected (32 of 56 units takes a task of at most 32). Blocks must stay
+ * aligned, so buddy memory is never compacted.
+ * Parameters:
+ * N/A
+**************************************************************************/
+struct BUDDY : FIT_POLICY
+{
+    vector<set<int>> freeList;                        // free block starts per order, block size 1 << order
+    int from = -1;                                    // order of the block find chose
+    void init(int memSize)
+    {
+        freeList.resize(32);
+        for(int start = 0, left = memSize; left > 0; )                         // largest aligned blocks first
+        {
+            int order = 31 - __builtin_clz(left);
+            freeList[order].insert(start);
+            start += 1 << order;
+            left -= 1 << order;
+        }
+    }
+    static int orderOf(int units) { return units <= 1 ? 0 : 32 - __builtin_clz(units - 1); }
+    int round(int size) { return 1 << orderOf(size); }
+    int find(MEMMAP&, HOLES&, int units, bool)
+    {
+        for(from = orderOf(units); from < (int)freeList.size(); from++)         // smallest free block that is big enough
+        {
+            METRIC(SEARCH_STEPS++);
+            if (!freeList[from].empty())
+            {
+                return *freeList[from].begin();
+            }
+        }
+        return -1;
+    }
+    void placed(MEMMAP& mem, HOLES& holes, int put, int units)
+    {
+        freeList[from].erase(put);
+        for(int order = from - 1; order >= orderOf(units); order--)            // split, keeping the upper halves free
+        {
+            freeList[order].insert(put + (1 << order));
+        }
+        takeUnits(mem, holes, put, units);
+    }
+    void released(MEMMAP& mem, HOLES& holes, int put, int units)
+    {
+        freeUnits(mem, holes, put, units);
+        int order = orderOf(units);
+        while (freeList[order].erase(put ^ (1 << order)))                       // merge while the buddy is free
+        {
+            put &= ~(1 << order);
+            order++;
+        }
+        freeList[order].insert(put);
+    }
+    bool movable(MEMMAP&, HOLES&) { return false; }
+    int largest(MEMMAP&, HOLES&)
+    {
+        for(int order = (int)freeList.size() - 1; order >= 0; order--)         // biggest free block
+        {
+            if (!freeList[order].empty())
+            {
+                return 1 << order;
+            }
+        }
+        return 0;
+    }
+    int limit(HOLES& holes) { return holes.size > 0 ? 1 << (31 - __builtin_clz(holes.size)) : 0; }   // first block init made
+    void save(SNAPSHOT& out)
+    {
+        for(size_t order = 0; order < freeList.size(); order++)
+        {
+            putVector(out, vector<int>(freeList[order].begin(), freeList[order].end()));
+        }
+    }
+    void load(SNAPSHOT& in)
+    {
+        vector<int> starts;
+        for(size_t order = 0; order < freeList.size(); order++)
+        {
+            getVector(in, starts);
+            freeList[order] = set<int>(starts.begin(), starts.end());
+        }
+    }
+};
+/***************************************************************************
+ * struct QUICK_FIT
+ * Description: segregated free lists. Requests are rounded up to a multiple of
+ * QUICK_GRAIN. Released blocks up to QUICK_CLASSES classes stay reserved on the
+ * list for their class and are handed out again in O(1). Other requests are
+ * first-fit from the general pool. When the pool cannot serve a request, every
+ * cached block is returned to it and coalesced before giving up.
+ * Parameters:
+ * N/A
+**************************************************************************/
+const int QUICK_GRAIN = 2;                            // quick-fit size classes are multiples of this many units
+const int QUICK_CLASSES = 16;                         // number of size classes with their own free list
+struct QUICK_FIT : FIT_POLICY
+{
+    vector<int> quick[QUICK_CLASSES + 1];             // cached block starts per size class
+    bool cached = false;                              // find chose a cached block
+    int round(int size) { return (size + QUICK_GRAIN - 1) / QUICK_GRAIN * QUICK_GRAIN; }
+    int find(MEMMAP& mem, HOLES& holes, int units, bool scan)
+    {
+        int cls = units / QUICK_GRAIN;
+        cached = cls <= QUICK_CLASSES && !quick[cls].empty();
+        METRIC(SEARCH_STEPS++);
+        if (cached)
+        {
+            return quick[cls].back();
+        }
+        int put = scan ? searchArr(mem, 0, units) : firstHole(holes, 0, units);
+        if (put < 0 && flush(mem, holes))                                       // give the cached blocks back and retry
+        {
+            put = scan ? searchArr(mem, 0, units) : firstHole(holes, 0, units);
+        }
+        return put;
+    }
+    bool flush(MEMMAP& mem, HOLES& holes)             // returns every cached block to the pool
+    {
+        bool flushed = false;
+        for(int c = 1; c <= QUICK_CLASSES; c++)
+        {
+            for(size_t b = 0; b < quick[c].size(); b++)
+            {
+                freeUnits(mem, holes, quick[c][b], c * QUICK_GRAIN);
+                flushed = true;
+            }
+            quick[c].clear();
+        }
+        return flushed;
+    }
+    bool movable(MEMMAP& mem, HOLES& holes)           // cached blocks have no task to move with, free them first
+    {
+        flush(mem, holes);
+        return true;
+    }
+    int largest(MEMMAP& mem, HOLES& holes)            // a cached class is served whole, or joins the pool on a miss
+    {
+        int cls = QUICK_CLASSES;
+        while (cls > 0 && quick[cls].empty())
+        {
+            cls--;
+        }
+        return max(FIT_POLICY::largest(mem, holes), cls * QUICK_GRAIN);
+    }
+    void save(SNAPSHOT& out)
+    {
+        for(int c = 1; c <= QUICK_CLASSES; c++)
+        {
+            putVector(out, quick[c]);
+        }
+    }
+    void load(SNAPSHOT& in)
+    {
+        for(int c = 1; c <= QUICK_CLASSES; c++)
+        {
+            getVector(in, quick[c]);
+        }
+    }
+    void placed(MEMMAP& mem, HOLES& holes, int put, int units)
+    {
+        if (cached)
+        {
+            quick[units / QUICK_GRAIN].pop_back();                              // already reserved
+            return;
+        }
+        takeUnits(mem, holes, put, units);
+    }
+    void released(MEMMAP& mem, HOLES& holes, int put, int units)
+    {
+        if (units / QUICK_GRAIN <= QUICK_CLASSES)
+        {
+            quick[units / QUICK_GRAIN].push_back(put);
+            return;
+        }
+        freeUnits(mem, holes, put, units);
+    }
+};
+/***************************************************************************
+ * struct METRICS
+ * Description: what one run of an algorithm measured. The time weighted values
+ * cover the placement phase, from the start until the last task is placed.
+ * External fragmentation is the mean over the regions of each region's own.
+ * Everything but totalTime, waste and the rejections is collected through
+ * METRIC and is zero when built with -DNO_METRICS.
+ * Parameters:
+ * N/A
+**************************************************************************/
+struct METRICS
+{
+    long long totalTime = 0;                          // total time value
+    long long placements = 0;                         // tasks placed
+    long long failed = 0;                             // placement attempts that found no room
+    long long searchSteps = 0;                        // holes, tree nodes and free lists visited while searching
+    long long waitSum = 0;                            // sum of the queue wait of every task
+    long long waitMax = 0;                            // longest queue wait of a task
+    double utilization = 0;                           // share of memory not in a hole
+    double external = 0;                              // external fragmentation, 1 - largest hole / free units
+    double holes = 0;                                 // number of holes
+    double waste = 0;                                 // internal fragmentation, share of reserved units not requested
+    long long compactions = 0;                        // times memory was compacted
+    long long unitsMoved = 0;                         // units moved by compaction
+    long long moveTime = 0;                           // clock ticks spent moving them
+    long long sloMissed = 0;                          // tasks that waited longer than the SLO
+    long long spilled = 0;                            // tasks placed outside the region they prefer
+    long long rejected = 0;                           // tasks too big to ever be placed, see rejectTask
+    long long rejectedUnits = 0;                      // biggest reservation a rejected task needed
+    long long largestBlock = 0;                       // biggest block the rejected tasks could have gone to
+};
+/***************************************************************************
+ * void sampleMemory(METRICS& metrics, MEMORY& memory, long long step)
+ * Description: adds the state of memory for the next step ticks to the time
+ * weighted metrics. Reads only the totals the regions publish.
+ * Parameters:
+ * metrics   I/O   METRICS&    metrics of the run
+ * memory    I/P   MEMORY&     regions of memory
+ * step      I/P   long long   ticks the state lasts
+**************************************************************************/
+void sampleMemory(METRICS& metrics, MEMORY& memory, long long step)
+{
+    metrics.utilization += (double)(memory.size - memory.free) / memory.size * step;
+    metrics.holes += (double)memory.holes * step;
+    metrics.external += memory.external / memory.count * step;
+}
+/***************************************************************************
+ * void addMetrics(METRICS& sum, const METRICS& run)
+ * Description: adds the metrics of one run into a running total.
+ * Parameters:
+ * sum   I/O   METRICS&         running total
+ * run   I/P   const METRICS&   metrics of one run
+**************************************************************************/
+void addMetrics(METRICS& sum, const METRICS& run)
+{
+    sum.totalTime += run.totalTime;
+    sum.placements += run.placements;
+    sum.failed += run.failed;
+    sum.searchSteps += run.searchSteps;
+    sum.waitSum += run.waitSum;
+    sum.waitMax = max(sum.waitMax, run.waitMax);
+    sum.utilization += run.utilization;
+    sum.external += run.external;
+    sum.holes += run.holes;
+    sum.waste += run.waste;
+    sum.compactions += run.compactions;
+    sum.unitsMoved += run.unitsMoved;
+    sum.moveTime += run.moveTime;
+    sum.sloMissed += run.sloMissed;
+    sum.spilled += run.spilled;
+    sum.rejected += run.rejected;
+    sum.rejectedUnits = max(sum.rejectedUnits, run.rejectedUnits);
+    sum.largestBlock = max(sum.largestBlock, run.largestBlock);
+}
+/***************************************************************************
+ * struct STATS
+ * void addSample(STATS& stats, double x)
+ * double ciHalf(const STATS& stats)
+ * Description: running mean and variance of a series, kept by Welford's method
+ * so no sum of squares can lose precision or overflow. ciHalf is the half
+ * width of the 95% confidence interval of the mean, with the Student t
+ * quantile approximated to first order in 1 / (n - 1); infinite below two
+ * samples.
+ * Parameters:
+ * stats   I/O   STATS&   series
+ * x       I/P   double   next sample
+**************************************************************************/
+struct STATS
+{
+    long long n = 0;                                  // samples seen
+    double mean = 0;                                  // their mean
+    double m2 = 0;                                    // sum of squared differences from the mean
+};
+void addSample(STATS& stats, double x)
+{
+    stats.n++;
+    double delta = x - stats.mean;
+    stats.mean += delta / stats.n;
+    stats.m2 += delta * (x - stats.mean);
+}
+double ciHalf(const STATS& stats)
+{
+    if (stats.n < 2)
+    {
+        return HUGE_VAL;
+    }
+    const double z = 1.959964;                        // two sided 95% quantile of the normal
+    double dof = stats.n - 1;
+    return (z + (z * z * z + z) / (4 * dof)) * sqrt(stats.m2 / dof / stats.n);
+}
+/***************************************************************************
+ * void printMetrics(ostream& out, const string& format, const string& point, const string& trial,
+ *                   const char* name, const METRICS& sum, int runs, double ci)
+ * Description: writes the mean over runs of a metrics total as one CSV line or JSON object,
+ * with the confidence interval of the total time when there is one.
+ * Parameters:
+ * out      I/O   ostream&         where to write
+ * format   I/P   const string&    "csv" or "json"
+ * point    I/P   const string&    fields naming the point of the grid, written first
+ * trial    I/P   const string&    experiment number, or "all" for the aggregate
+ * name     I/P   const char*      name of the algorithm
+ * sum      I/P   const METRICS&   metrics total
+ * runs     I/P   int              number of runs in the total
+ * ci       I/P   double           half width of the 95% interval of the mean total time, below 0 for none
+**************************************************************************/
+void printMetrics(ostream& out, const string& format, const string& point, const string& trial,
+                  const char* name, const METRICS& sum, int runs, double ci)
+{
+    double wait = sum.placements > 0 ? (double)sum.waitSum / sum.placements : 0;
+    if (format == "csv")
+    {
+        out << point << "," << trial << "," << name << "," << (double)sum.totalTime / runs << "," << (double)sum.placements / runs
+             << "," << (double)sum.failed / runs << "," << (double)sum.searchSteps / runs << "," << wait
+             << "," << sum.waitMax << "," << sum.utilization / runs << "," << sum.external / runs
+             << "," << sum.holes / runs << "," << sum.waste / runs << "," << (double)sum.compactions / runs
+             << "," << (double)sum.unitsMoved / runs << "," << (double)sum.moveTime / runs
+             << "," << (double)sum.sloMissed / runs << "," << (double)sum.spilled / runs
+             << "," << (double)sum.rejected / runs << ",";
+        if (ci >= 0)
+        {
+            out << ci;
+        }
+        out << endl;
+        return;
+    }
+    out << "{" << point << "\"trial\":\"" << trial << "\",\"policy\":\"" << name << "\",\"total_time\":" << (double)sum.totalTime / runs
+         << ",\"placements\":" << (double)sum.placements / runs << ",\"failed\":" << (double)sum.failed / runs
+         << ",\"search_steps\":" << (double)sum.searchSteps / runs << ",\"mean_wait\":" << wait
+         << ",\"max_wait\":" << sum.waitMax << ",\"utilization\":" << sum.utilization / runs
+         << ",\"external_fragmentation\":" << sum.external / runs << ",\"mean_holes\":" << sum.holes / runs
+         << ",\"internal_fragmentation\":" << sum.waste / runs << ",\"compactions\":" << (double)sum.compactions / runs
+         << ",\"units_moved\":" << (double)sum.unitsMoved / runs << ",\"move_time\":" << (double)sum.moveTime / runs
+         << ",\"slo_missed\":" << (double)sum.sloMissed / runs << ",\"spilled\":" << (double)sum.spilled / runs
+         << ",\"rejected\":" << (double)sum.rejected / runs;
+    if (ci >= 0)
+    {
+        out << ",\"total_time_ci\":" << ci;
+    }
+    out << "}";
+}
+/***************************************************************************
+ * struct COMPACTION
+ * Description: when simulate compacts memory and what it costs. "fail" compacts
+ * when the task at the head of the stream does not fit but the free units in
+ * all holes would hold it. "frag:X" compacts whenever external fragmentation
+ * (1 - largest hole / free units) is above X. Moving memory stalls placement
+ * for moveCost clock ticks per unit moved, rounded up; resident tasks keep
+ * running meanwhile.
+ * Parameters:
+ * N/A
+**************************************************************************/
+const int COMPACT_NEVER = 0;
+const int COMPACT_FAIL = 1;
+const int COMPACT_FRAG = 2;
+struct COMPACTION
+{
+    int when = COMPACT_NEVER;                         // what triggers a compaction
+    double threshold = 0.5;                           // external fragmentation that triggers COMPACT_FRAG
+    double moveCost = 0;                              // clock ticks per unit moved
+};
+/***************************************************************************
+ * long long compactMem(MEMMAP& mem, HOLES& holes, EVENTS& events, STREAM& arr, int region)
+ * Description: slides every resident extent of a region down by the free units below it,
+ * leaving one hole at the top of memory, and returns the number of units moved.
+ * One pass over the holes gives the free units below each hole's end, and one
+ * pass over the release queue moves each extent, updating its owner and the
+ * location of its task when the task is in the stream window. Only the span
+ * from the first hole to the last used unit changes, so the bitmap is
+ * rewritten there alone, and the index just drops the old holes and gains the
+ * new one: the cost follows the holes and extents, not the memory size.
+ * Sliding keeps extents in address order, so the release queue stays a valid heap.
+ * Parameters:
+ * mem      I/O   MEMMAP&    memory map
+ * holes    I/O   HOLES&     free-extent index of mem
+ * events   I/O   EVENTS&    release queue of resident tasks
+ * arr      I/O   STREAM&    info stream, location of moved tasks is updated
+ * region   I/P   int        region mem and holes belong to
+**************************************************************************/
+long long compactMem(MEMMAP& mem, HOLES& holes, EVENTS& events, STREAM& arr, int region)
+{
+    vector<pair<int,long long>> below;                                          // hole start -> free units up to its end
+    long long freeUnits = 0;
+    for(map<int,int>::iterator it = holes.byAddr.begin(); it != holes.byAddr.end(); it++)
+    {
+        freeUnits += it->second;
+        below.push_back(make_pair(it->first, freeUnits));
+    }
+    long long moved = 0;
+    unordered_map<int,long long> owner;
+    owner.reserve(mem.owner.size());
+    vector<RELEASE>& extents = events.extents();
+    for(size_t e=0; e<extents.size(); e++)
+    {
+        RELEASE& extent = extents[e];
+        if (extent.region != region)
+        {
+            continue;
+        }
+        vector<pair<int,long long>>::iterator hole = upper_bound(below.begin(), below.end(),
+                                                                 make_pair(extent.location, LLONG_MAX));
+        int shift = hole == below.begin() ? 0 : (int)prev(hole)->second;   // every hole before the extent is below it
+        long long task = mem.owner[extent.location];
+        extent.location -= shift;
+        owner[extent.location] = task;
+        if (task >= arr.first && task < arr.first + arr.count)
+        {
+            arr.location[task - arr.first] = extent.location;
+        }
+        moved += shift > 0 ? extent.units : 0;
+    }
+    mem.owner.swap(owner);
+    int used = mem.size - (int)holes.total;
+    int low = holes.byAddr.begin()->first;                                      // nothing below the first hole moves
+    map<int,int>::reverse_iterator last = holes.byAddr.rbegin();
+    int top = last->first + last->second == mem.size ? last->first : mem.size;   // nor is anything above the last used unit
+    setUnits(mem, low, used - low, true);
+    setUnits(mem, used, top - used, false);
+    while (!holes.byAddr.empty())
+    {
+        dropHole(holes, holes.byAddr.begin()->first, holes.byAddr.begin()->second);
+    }
+    addHole(holes, used, mem.size - used);
+    return moved;
+}
+/***************************************************************************
+ * struct SCHEDULER, READY
+ * Description: which waiting task simulate places next. "fifo" places tasks in
+ * stream order and stops at the first one that does not fit, as the original
+ * loop did. The others choose among the window tasks starting at the head, the
+ * oldest task not placed yet. "backfill" tries the head and then fills the room
+ * left with the largest waiting task that fits. "sjf" places the shortest
+ * waiting task that fits. Once the head has waited more than aging ticks no
+ * other task may pass it, so memory drains until it fits. slo is the longest
+ * wait, from arrival to placement, a task is allowed. Tasks over it are counted
+ * but do not change the order.
+ * READY holds the window tasks that have arrived and are not placed. For
+ * backfill they are keyed by reserved units, so the largest task that fits is
+ * one lookup in the ordered set. For sjf they are keyed by time and walked from
+ * the shortest until one fits. With a trace schedule moves the stream window on
+ * to the head whenever it holds window tasks from the head on or fewer, so the
+ * tasks looked at, and the order, do not depend on how many tasks it holds.
+ * Parameters:
+ * N/A
+**************************************************************************/
+const int ORDER_FIFO = 0;
+const int ORDER_BACKFILL = 1;
+const int ORDER_SJF = 2;
+const int NUM_ORDERS = 3;
+const char* const ORDER_NAMES[NUM_ORDERS] = {"fifo", "backfill", "sjf"};
+struct SCHEDULER
+{
+    int order = ORDER_FIFO;                           // index into ORDER_NAMES
+    int window = 64;                                  // tasks from the head on that may be placed
+    long long aging = LLONG_MAX;                      // wait after which the head blocks every other task
+    long long slo = LLONG_MAX;                        // longest wait a task is allowed
+};
+struct READY
+{
+    set<pair<int,int>> tasks;                         // (units or time, task) of arrived tasks not placed yet
+    int horizon = 0;                                  // next task of the stream to be admitted
+};
+/***************************************************************************
+ * struct WORKSPACE
+ * Description: memory an algorithm runs in. Each worker keeps one and simulate
+ * resets it for every run, so its buffers are allocated once per worker instead
+ * of once per run. A task whose region is full waits for it ("none"), or
+ * spills to the next region with room ("next") or to the one with the most
+ * room ("largest").
+ * Parameters:
+ * N/A
+**************************************************************************/
+const int SPILL_NONE = 0;
+const int SPILL_NEXT = 1;
+const int SPILL_LARGEST = 2;
+const int NUM_SPILLS = 3;
+const char* const SPILL_NAMES[NUM_SPILLS] = {"none", "next", "largest"};
+struct WORKSPACE
+{
+    int memSize = 56;                                 // number of allocation units in memory, all regions together
+    int regions = 1;                                  // number of regions memory is split into
+    int spill = SPILL_NONE;                           // where a task goes when its region is full, index into SPILL_NAMES
+    MEMORY memory;                                    // the regions
+    EVENTS events;                                    // release queue, empty between runs
+    COMPACTION compact;                               // when to compact memory
+    SCHEDULER sched;                                  // which waiting task is placed next
+    READY ready;                                      // tasks the scheduler picks from, empty between runs
+    CHECKPOINT* checkpoint = nullptr;                 // checkpoints taken while a trace replays, or nullptr
+    SNAPSHOT* restore = nullptr;                      // run state the next simulate carries on from, or nullptr
+};
+/***************************************************************************
+ * bool compact(WORKSPACE& work, STREAM& arr, POLICY policy[], COUNTS& live, METRICS& metrics,
+ *              long long& totalTime, int r)
+ * Description: compacts region r if its policy allows it and charges the move
+ * cost by moving the clock on, releasing whatever is due meanwhile. Returns
+ * false when the policy's blocks cannot move.
+ * Parameters:
+ * work       I/O   WORKSPACE&   memory to compact
+ * arr        I/O   STREAM&      info stream of tasks
+ * policy     I/O   POLICY[]     placement policy of each region
+ * live       I/O   COUNTS&      live counts of the run
+ * metrics    I/O   METRICS&     metrics of the run
+ * totalTime  I/O   long long&   current clock time
+ * r          I/P   int          region to compact
+**************************************************************************/
+template <class POLICY>
+bool compact(WORKSPACE& work, STREAM& arr, POLICY policy[], COUNTS& live, METRICS& metrics, long long& totalTime, int r)
+{
+    REGION& region = work.memory.region[r];
+    if (!policy[r].movable(region.mem, region.holes))
+    {
+        return false;
+    }
+    long long moved = compactMem(region.mem, region.holes, work.events, arr, r);
+    touchRegion(work.memory, policy[r], r);
+    long long stall = (long long)ceil(moved * work.compact.moveCost);
+    metrics.compactions++;
+    metrics.unitsMoved += moved;
+    metrics.moveTime += stall;
+    if (stall > 0)
+    {
+        METRIC(sampleMemory(metrics, work.memory, stall));
+        int released = incrementTime(work.memory, work.events, policy, totalTime, stall);
+        live.resident -= released;
+        live.completed += released;
+    }
+    return true;
+}
+/***************************************************************************
+ * int findRegion(WORKSPACE& work, POLICY policy[], int home, int units, bool scan, int& r)
+ * Description: finds room for units in region home, or when it is full and
+ * work.spill allows, in the region the room tree gives: "next" is the first
+ * region after home with room, wrapping around, and "largest" the region with
+ * the most room. Either is one walk down the tree. Returns the first unit, or
+ * -1 if the task fits nowhere it may go, and sets r to the region.
+ * Parameters:
+ * work    I/O   WORKSPACE&   memory to search
+ * policy  I/O   POLICY[]     placement policy of each region
+ * home    I/P   int          region the task prefers
+ * units   I/P   int          units to reserve
+ * scan    I/P   bool         use the bitmap scans of mem instead of the hole index
+ * r       O/P   int&         region the reservation goes in
+**************************************************************************/
+template <class POLICY>
+int findRegion(WORKSPACE& work, POLICY policy[], int home, int units, bool scan, int& r)
+{
+    MEMORY& memory = work.memory;
+    r = home;
+    int put = policy[r].find(memory.region[r].mem, memory.region[r].holes, units, scan);
+    if (put >= 0)
+    {
+        return put;
+    }
+    touchRegion(memory, policy[r], r);                                  // a miss may have given quick-fit's cache back
+    if (memory.count == 1 || work.spill == SPILL_NONE)
+    {
+        return -1;
+    }
+    HOLES& rooms = memory.rooms;
+    if (work.spill == SPILL_NEXT)
+    {
+        r = lowestStart(rooms, 1, 0, rooms.leaves, home + 1, memory.count, units);
+        if (r < 0)                                                      // returns to the first region
+        {
+            r = lowestStart(rooms, 1, 0, rooms.leaves, 0, home, units);
+        }
+    }
+    else
+    {
+        r = rooms.tree[1] >= units ? lowestStart(rooms, 1, 0, rooms.leaves, 0, memory.count, rooms.tree[1]) : -1;
+    }
+    if (r < 0)
+    {
+        r = home;
+        return -1;
+    }
+    return policy[r].find(memory.region[r].mem, memory.region[r].holes, units, scan);
+}
+/***************************************************************************
+ * void place(WORKSPACE& work, STREAM& arr, POLICY policy[], COUNTS& live, METRICS& metrics,
+ *            int task, int r, int put, int units, long long totalTime)
+ * Description: reserves the units find chose for a task and updates the live
+ * counts and the metrics of the run.
+ * Parameters:
+ * work       I/O   WORKSPACE&   memory the task goes into
+ * arr        I/O   STREAM&      info stream of tasks
+ * policy     I/O   POLICY[]     placement policy of each region
+ * live       I/O   COUNTS&      live counts of the run
+ * metrics    I/O   METRICS&     metrics of the run
+ * task       I/P   int          index of the task in the stream
+ * r          I/P   int          region of the reservation
+ * put        I/P   int          first unit of the reservation
+ * units      I/P   int          units reserved
+ * totalTime  I/P   long long    current clock time
+**************************************************************************/
+template <class POLICY>
+void place(WORKSPACE& work, STREAM& arr, POLICY policy[], COUNTS& live, METRICS& metrics,
+           int task, int r, int put, int units, long long totalTime)
+{
+    REGION& region = work.memory.region[r];
+    policy[r].placed(region.mem, region.holes, put, units);
+    touchRegion(work.memory, policy[r], r);
+    addToMem(region.mem, work.events, arr, task, put, units, totalTime, r);   // Place item on taskStream at put
+    live.queued++;
+    live.resident++;
+    live.lastDue = max(live.lastDue, arr.due[task]);
+    live.requested += arr.size[task];
+    live.reserved += units;
+    (void)metrics;                                                      // only read through METRIC
+    METRIC(long long wait = arr.tTime[task] - arr.time[task]);
+    METRIC(metrics.placements++);
+    METRIC(metrics.waitSum += wait);
+    METRIC(metrics.waitMax = max(metrics.waitMax, wait));
+    METRIC(metrics.sloMissed += wait > work.sched.slo);
+    METRIC(metrics.spilled += r != homeOf(arr, task, work.memory.count));
+}
+/***************************************************************************
+ * bool rejectTask(WORKSPACE& work, STREAM& arr, POLICY policy[], COUNTS& live, METRICS& metrics, int task)
+ * Description: passes over a task that could never be placed, one whose
+ * reservation is bigger than the largest block of every region it may go to
+ * even with the region empty. Such a task is marked QUEUED so the stream moves
+ * on, counted in metrics.rejected, and never placed. Returns whether it was.
+ * Parameters:
+ * work     I/P   WORKSPACE&   memory and spill policy
+ * arr      I/O   STREAM&      info stream of tasks
+ * policy   I/O   POLICY[]     placement policy of each region
+ * live     I/O   COUNTS&      live counts of the run
+ * metrics  I/O   METRICS&     metrics of the run
+ * task     I/P   int          task that has arrived
+**************************************************************************/
+template <class POLICY>
+bool rejectTask(WORKSPACE& work, STREAM& arr, POLICY policy[], COUNTS& live, METRICS& metrics, int task)
+{
+    MEMORY& memory = work.memory;
+    int units = policy[0].round(arr.size[task]), home = homeOf(arr, task, memory.count);
+    int block = policy[home].limit(memory.region[home].holes);
+    for(int r=0; work.spill != SPILL_NONE && r<memory.count; r++)             // a spilling task may go anywhere
+    {
+        block = max(block, policy[r].limit(memory.region[r].holes));
+    }
+    if (units <= block)
+    {
+        return false;
+    }
+    arr.status[task] |= QUEUED;
+    live.queued++;
+    metrics.rejected++;
+    metrics.rejectedUnits = max(metrics.rejectedUnits, (long long)units);
+    metrics.largestBlock = max(metrics.largestBlock, (long long)block);
+    return true;
+}
+/***************************************************************************
+ * void admitTasks(READY& ready, STREAM& arr, const SCHEDULER& sched, POLICY& policy, int head, long long now)
+ * Description: adds the tasks of the window starting at head that have arrived
+ * by now to READY. Tasks arrive in stream order, so only the ones from
+ * ready.horizon on are looked at.
+ * Parameters:
+ * ready    I/O   READY&             tasks the scheduler picks from
+ * arr      I/P   STREAM&            info stream of tasks
+ * sched    I/P   const SCHEDULER&   scheduler settings
+ * policy   I/O   POLICY&            placement policy, rounds the sizes
+ * head     I/P   int                oldest task not placed yet
+ * now      I/P   long long          current clock time
+**************************************************************************/
+template <class POLICY>
+void admitTasks(READY& ready, STREAM& arr, const SCHEDULER& sched, POLICY& policy, int head, long long now)
+{
+    int end = (int)min((long long)arr.count, (long long)head + sched.window);
+    for(; ready.horizon < end && arr.arrive[ready.horizon] <= now; ready.horizon++)
+    {
+        int task = ready.horizon;
+        int key = sched.order == ORDER_BACKFILL ? policy.round(arr.size[task]) : arr.time[task];
+        ready.tasks.insert(make_pair(key, task));
+    }
+}
+/***************************************************************************
+ * int pickTask(WORKSPACE& work, READY& ready, STREAM& arr, POLICY& policy, int room)
+ * Description: the waiting task that goes into room units, or -1 if none fits.
+ * backfill takes the largest task of at most room units with one ordered-set
+ * lookup. sjf takes the shortest task that fits, walking the tasks by time.
+ * When memory has regions and tasks may not spill, room is the biggest room of
+ * any region, so tasks whose own region is too full are passed over.
+ * Parameters:
+ * work     I/P   WORKSPACE&   memory and scheduler settings
+ * ready    I/P   READY&       tasks the scheduler picks from
+ * arr      I/P   STREAM&      info stream of tasks
+ * policy   I/O   POLICY&      placement policy, rounds the sizes
+ * room     I/P   int          biggest reservation a policy can serve now
+**************************************************************************/
+template <class POLICY>
+int pickTask(WORKSPACE& work, READY& ready, STREAM& arr, POLICY& policy, int room)
+{
+    MEMORY& memory = work.memory;
+    bool anywhere = memory.count == 1 || work.spill != SPILL_NONE;     // fitting the biggest room is enough
+    METRIC(SEARCH_STEPS++);
+    if (work.sched.order == ORDER_BACKFILL)
+    {
+        set<pair<int,int>>::iterator it = ready.tasks.upper_bound(make_pair(room, INT_MAX));
+        while (it != ready.tasks.begin())
+        {
+            it--;
+            if (anywhere || memory.region[homeOf(arr, it->second, memory.count)].room >= it->first)
+            {
+                return it->second;
+            }
+            METRIC(SEARCH_STEPS++);
+        }
+        return -1;
+    }
+    for(set<pair<int,int>>::iterator it = ready.tasks.begin(); it != ready.tasks.end(); it++)
+    {
+        METRIC(SEARCH_STEPS++);
+        int units = policy.round(arr.size[it->second]);
+        if (units <= room && (anywhere || memory.region[homeOf(arr, it->second, memory.count)].room >= units))
+        {
+            return it->second;
+        }
+    }
+    return -1;
+}
+/***************************************************************************
+ * int moveHead(READY& ready, STREAM& arr, TRACE* trace, const SCHEDULER& sched, int head)
+ * Description: returns the new head once the head is placed or rejected, the
+ * next task not queued. With a trace the stream window is moved on to the
+ * head, and the tasks in READY renumbered, whenever it holds sched.window
+ * tasks from the head on or fewer.
+ * Parameters:
+ * ready    I/O   READY&             tasks the scheduler picks from
+ * arr      I/O   STREAM&            info stream of tasks
+ * trace    I/P   TRACE*             trace to replay through arr, or nullptr
+ * sched    I/P   const SCHEDULER&   scheduler settings
+ * head     I/P   int                head that has just been queued
+**************************************************************************/
+int moveHead(READY& ready, STREAM& arr, TRACE* trace, const SCHEDULER& sched, int head)
+{
+    while (head < arr.count && (arr.status[head] & QUEUED))           // the head moves past queued tasks
+    {
+        head++;
+    }
+    if (trace != nullptr && head + sched.window >= arr.count && readTasks(*trace, arr, head))   // keep the lookahead loaded
+    {
+        set<pair<int,int>> moved;                                       // the window now starts at the head
+        for(set<pair<int,int>>::iterator it = ready.tasks.begin(); it != ready.tasks.end(); it++)
+        {
+            moved.insert(moved.end(), make_pair(it->first, it->second - head));
+        }
+        ready.tasks.swap(moved);
+        ready.horizon -= head;
+        head = 0;
+    }
+    return head;
+}
+/***************************************************************************
+ * int schedule(WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, POLICY policy[],
+ *              COUNTS& live, METRICS& metrics, long long& totalTime, int head)
+ * Description: places waiting tasks in the order work.sched gives until none of
+ * them fits, and returns the new head. backfill tries the head first. An aged
+ * head is the only task tried. Otherwise pickTask chooses a task for the room
+ * left. Quick-fit only returns its cached blocks to the pool when find misses,
+ * so the head is also tried when pickTask finds nothing. A head that fits only
+ * once the holes of its region are joined triggers compaction as in simulate.
+ * Tasks that can never be placed are rejected when they reach the head.
+ * Parameters:
+ * work       I/O   WORKSPACE&   memory to run in
+ * arr        I/O   STREAM&      info stream of tasks
+ * trace      I/P   TRACE*       trace to replay through arr, or nullptr
+ * scan       I/P   bool         use the bitmap scans of mem instead of the hole index
+ * policy     I/O   POLICY[]     placement policy of each region
+ * live       I/O   COUNTS&      live counts of the run
+ * metrics    I/O   METRICS&     metrics of the run
+ * totalTime  I/O   long long&   current clock time
+ * head       I/P   int          oldest task not placed yet
+**************************************************************************/
+template <class POLICY>
+int schedule(WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, POLICY policy[],
+             COUNTS& live, METRICS& metrics, long long& totalTime, int head)
+{
+    const SCHEDULER& sched = work.sched;
+    READY& ready = work.ready;
+    MEMORY& memory = work.memory;
+    while (head < arr.count)
+    {
+        admitTasks(ready, arr, sched, policy[0], head, totalTime);
+        bool arrived = arr.arrive[head] <= totalTime;
+        if (arrived && rejectTask(work, arr, policy, live, metrics, head))   // never fits, the head moves on
+        {
+            ready.tasks.erase(make_pair(sched.order == ORDER_BACKFILL ? policy[0].round(arr.size[head]) : arr.time[head], head));
+            head = moveHead(ready, arr, trace, sched, head);
+            continue;
+        }
+        bool aged = arrived && totalTime - arr.arrive[head] > sched.aging;
+        bool tried = arrived && (sched.order == ORDER_BACKFILL || aged);
+        int task = head, units = policy[0].round(arr.size[head]), r = 0;
+        int put = tried ? findRegion(work, policy, homeOf(arr, head, memory.count), units, scan, r) : -1;
+        if (put < 0 && !aged)                                           // the room left goes to the task READY picks
+        {
+            task = pickTask(work, ready, arr, policy[0], memory.rooms.tree[1]);
+            if (task >= 0)
+            {
+                units = policy[0].round(arr.size[task]);
+                put = findRegion(work, policy, homeOf(arr, task, memory.count), units, scan, r);
+            }
+        }
+        if (put < 0 && arrived && !tried)
+        {
+            task = head;
+            units = policy[0].round(arr.size[head]);
+            put = findRegion(work, policy, homeOf(arr, head, memory.count), units, scan, r);
+        }
+        if (put < 0)
+        {
+            int home = homeOf(arr, head, memory.count);
+            HOLES& holes = memory.region[home].holes;
+            if (arrived && work.compact.when == COMPACT_FAIL && holes.total >= policy[0].round(arr.size[head])
+                && holes.byAddr.size() > 1 && compact(work, arr, policy, live, metrics, totalTime, home))
+            {
+                continue;                                               // the head fits once the holes are joined
+            }
+            METRIC(metrics.failed += !ready.tasks.empty());
+            break;
+        }
+        place(work, arr, policy, live, metrics, task, r, put, units, totalTime);
+        ready.tasks.erase(make_pair(sched.order == ORDER_BACKFILL ? units : arr.time[task], task));
+        head = moveHead(ready, arr, trace, sched, head);
+    }
+    return head;
+}
+/***************************************************************************
+ * void saveRun(SNAPSHOT& out, WORKSPACE& work, STREAM& arr, TRACE* trace, POLICY policy[], COUNTS& live,
+ *              METRICS& metrics, long long totalTime, int current, long long steps)
+ * Description: writes the state of a simulation at the top of its loop: the
+ * clock, counts and metrics so far, the position in the trace, the stream
+ * window, each region's bitmap, owners, published totals and policy, the
+ * release queue and the ready set. The hole index is left out, restoreRun
+ * rebuilds it from the bitmap.
+ * Parameters:
+ * out        I/O   SNAPSHOT&    checkpoint being written
+ * work       I/P   WORKSPACE&   memory the run is in
+ * arr        I/P   STREAM&      info stream of tasks
+ * trace      I/P   TRACE*       trace being replayed, or nullptr
+ * policy     I/P   POLICY[]     placement policy of each region
+ * live       I/P   COUNTS&      live counts of the run
+ * metrics    I/P   METRICS&     metrics so far
+ * totalTime  I/P   long long    current clock time
+ * current    I/P   int          head of the stream window
+ * steps      I/P   long long    SEARCH_STEPS when the run started
+**************************************************************************/
+template <class POLICY>
+void saveRun(SNAPSHOT& out, WORKSPACE& work, STREAM& arr, TRACE* trace, POLICY policy[], COUNTS& live,
+             METRICS& metrics, long long totalTime, int current, long long steps)
+{
+    putValue(out, totalTime);
+    putValue(out, current);
+    putValue(out, live);
+    putValue(out, metrics);
+    putValue(out, SEARCH_STEPS - steps);
+    putValue(out, trace != nullptr ? trace->read : 0LL);
+    putValue(out, trace != nullptr ? (long long)ftello(trace->file) : 0LL);
+    putValue(out, arr.first);
+    putValue(out, arr.count);
+    putBytes(out, arr.size, arr.count * sizeof(int));
+    putBytes(out, arr.time, arr.count * sizeof(int));
+    putBytes(out, arr.oTime, arr.count * sizeof(int));
+    putBytes(out, arr.arrive, arr.count * sizeof(long long));
+    putBytes(out, arr.tTime, arr.count * sizeof(long long));
+    putBytes(out, arr.location, arr.count * sizeof(int));
+    putBytes(out, arr.alloc, arr.count * sizeof(int));
+    putBytes(out, arr.due, arr.count * sizeof(long long));
+    putBytes(out, arr.region, arr.count * sizeof(int));
+    putBytes(out, arr.status, arr.count);
+    MEMORY& memory = work.memory;
+    putValue(out, memory.count);
+    putValue(out, memory.free);
+    putValue(out, memory.holes);
+    putValue(out, memory.external);
+    for(int r=0; r<memory.count; r++)
+    {
+        REGION& region = memory.region[r];
+        putVector(out, region.mem.bits);
+        putVector(out, vector<pair<int,long long>>(region.mem.owner.begin(), region.mem.owner.end()));
+        putValue(out, region.free);
+        putValue(out, region.holeCount);
+        putValue(out, region.external);
+        putValue(out, region.room);
+        policy[r].save(out);
+    }
+    putVector(out, work.events.extents());
+    putValue(out, work.ready.horizon);
+    putVector(out, vector<pair<int,int>>(work.ready.tasks.begin(), work.ready.tasks.end()));
+}
+/***************************************************************************
+ * void restoreRun(SNAPSHOT& in, WORKSPACE& work, STREAM& arr, TRACE* trace, POLICY policy[], COUNTS& live,
+ *                 METRICS& metrics, long long& totalTime, int& current, long long& steps)
+ * Description: reads back what saveRun wrote into a simulation that has just
+ * been set up, so it carries on exactly where the checkpoint was taken.
+ * Parameters:
+ * in         I/O   SNAPSHOT&    checkpoint being read
+ * work       I/O   WORKSPACE&   memory the run is in
+ * arr        O/P   STREAM&      info stream of tasks
+ * trace      I/O   TRACE*       trace being replayed, or nullptr
+ * policy     O/P   POLICY[]     placement policy of each region
+ * live       O/P   COUNTS&      live counts of the run
+ * metrics    O/P   METRICS&     metrics so far
+ * totalTime  O/P   long long&   clock time
+ * current    O/P   int&         head of the stream window
+ * steps      O/P   long long&   SEARCH_STEPS as if the run started in this process
+**************************************************************************/
+template <class POLICY>
+void restoreRun(SNAPSHOT& in, WORKSPACE& work, STREAM& arr, TRACE* trace, POLICY policy[], COUNTS& live,
+                METRICS& metrics, long long& totalTime, int& current, long long& steps)
+{
+    long long searched = 0, read = 0, offset = 0;
+    getValue(in, totalTime);
+    getValue(in, current);
+    getValue(in, live);
+    getValue(in, metrics);
+    getValue(in, searched);
+    getValue(in, read);
+    getValue(in, offset);
+    if (trace != nullptr)
+    {
+        trace->read = read;
+        fseeko(trace->file, offset, SEEK_SET);
+    }
+    getValue(in, arr.first);
+    getValue(in, arr.count);
+    if (arr.count < 0 || arr.count > arr.capacity)
+    {
+        in.bad = true;
+        arr.count = 0;
+    }
+    getBytes(in, arr.size, arr.count * sizeof(int));
+    getBytes(in, arr.time, arr.count * sizeof(int));
+    getBytes(in, arr.oTime, arr.count * sizeof(int));
+    getBytes(in, arr.arrive, arr.count * sizeof(long long));
+    getBytes(in, arr.tTime, arr.count * sizeof(long long));
+    getBytes(in, arr.location, arr.count * sizeof(int));
+    getBytes(in, arr.alloc, arr.count * sizeof(int));
+    getBytes(in, arr.due, arr.count * sizeof(long long));
+    getBytes(in, arr.region, arr.count * sizeof(int));
+    getBytes(in, arr.status, arr.count);
+    MEMORY& memory = work.memory;
+    int count = 0;
+    getValue(in, count);
+    getValue(in, memory.free);
+    getValue(in, memory.holes);
+    getValue(in, memory.external);
+    vector<pair<int,long long>> owners;
+    for(int r=0; r<memory.count && count == memory.count; r++)
+    {
+        REGION& region = memory.region[r];
+        size_t words = region.mem.bits.size();
+        getVector(in, region.mem.bits);
+        getVector(in, owners);
+        region.mem.owner = unordered_map<int,long long>(owners.begin(), owners.end());
+        getValue(in, region.free);
+        getValue(in, region.holeCount);
+        getValue(in, region.external);
+        getValue(in, region.room);
+        policy[r].load(in);
+        if (region.mem.bits.size() != words)
+        {
+            in.bad = true;
+            break;
+        }
+        HOLES& holes = region.holes;                                            // the index is whatever the bitmap leaves free
+        dropHole(holes, 0, holes.size);
+        int start, len;
+        for(int from = 0; nextHole(region.mem, from, start, len, INT_MAX); from = start + len)
+        {
+            addHole(holes, start, len);
+        }
+        if (memory.tracked)
+        {
+            setStart(memory.rooms, r, region.room);
+        }
+    }
+    getVector(in, work.events.extents());
+    getValue(in, work.ready.horizon);
+    vector<pair<int,int>> ready;
+    getVector(in, ready);
+    work.ready.tasks = set<pair<int,int>>(ready.begin(), ready.end());
+    if (in.bad || count != memory.count)
+    {
+        cerr << " checkpoint is damaged" << endl;
+        exit(1);
+    }
+    steps = SEARCH_STEPS - searched;
+}
+/***************************************************************************
+ * long long simulate(WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+ * Description: runs the info stream through memory with placement policy POLICY.
+ * Tasks are placed in order until one does not fit or has not arrived yet, then
+ * the clock jumps to the next release or arrival. A task bigger than any block
+ * it may go to is rejected when it arrives (see rejectTask), so a task that
+ * does not fit always has a release to wait for. With a trace the stream is a
+ * window that moves on once every task in it has been placed, or for schedule
+ * once it holds too few tasks past the head. Once every
+ * task is placed the time to drain memory is added. Progress is read from live
+ * counts, never from a scan of the stream or of memory. work.compact says when
+ * memory is compacted. Unless work.sched is fifo, schedule picks the order in
+ * which waiting tasks are placed, and the head is the oldest task not placed.
+ * Memory is split into work.regions regions, each with its own instance of
+ * POLICY, and a task goes to the region it prefers or spills as work.spill says.
+ * With work.checkpoint set the run is checkpointed when one is due, and with
+ * work.restore set it carries on from the state in it instead of starting over.
+ * Parameters:
+ * work   I/O   WORKSPACE&   memory to run in, work.memSize units
+ * arr    I/P   STREAM&      info stream of tasks to be processed in memory
+ * trace  I/P   TRACE*       trace to replay through arr, or nullptr
+ * scan   I/P   bool         use the bitmap scans of mem instead of the hole index
+ * metrics O/P  METRICS&     what the run measured
+**************************************************************************/
+template <class POLICY>
+long long simulate(WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+{
+    MEMORY& memory = work.memory;                                       // Resets the memory map
+    initMemory(memory, work.memSize, work.regions);
+    memory.tracked = work.sched.order != ORDER_FIFO || (memory.count > 1 && work.spill != SPILL_NONE);
+    EVENTS& events = work.events;
+    events.clear();
+    COUNTS live;
+    vector<POLICY> regionPolicy(memory.count);                          // every region has its own free structures
+    POLICY* policy = regionPolicy.data();
+    for(int r=0; r<memory.count; r++)
+    {
+        policy[r].init(memory.region[r].holes.size);
+        touchRegion(memory, policy[r], r);
+    }
+    work.ready.tasks.clear();
+    work.ready.horizon = 0;
+    long long totalTime = 0;
+    int current = 0, put;
+    metrics = METRICS();
+    long long steps = SEARCH_STEPS;
+    if (work.restore != nullptr)                                        // carry on from a checkpoint
+    {
+        restoreRun(*work.restore, work, arr, trace, policy, live, metrics, totalTime, current, steps);
+        work.restore = nullptr;
+    }
+    else if (trace != nullptr)
+    {
+        rewindTrace(*trace);
+        readTasks(*trace, arr, arr.count);
+    }
+    for(int rounds = 1; live.queued < arr.first + arr.count; rounds++)  // While not all tasks have been placed
+    {
+        if (work.checkpoint != nullptr && rounds % 1024 == 0 && checkpointDue(*work.checkpoint))
+        {
+            CHECKPOINT& cp = *work.checkpoint;
+            SNAPSHOT& out = beginCheckpoint(cp);
+            putBytes(out, cp.context.data.data(), cp.context.data.size());
+            saveRun(out, work, arr, trace, policy, live, metrics, totalTime, current, steps);
+            commitCheckpoint(cp);
+        }
+        for(int r=0; work.compact.when == COMPACT_FRAG && r<memory.count; r++)   // every region that is too fragmented
+        {
+            if (memory.region[r].holes.byAddr.size() > 1 && memory.region[r].external > work.compact.threshold)
+            {
+                compact(work, arr, policy, live, metrics, totalTime, r);
+            }
+        }
+        if (work.sched.order != ORDER_FIFO)
+        {
+            current = schedule(work, arr, trace, scan, policy, live, metrics, totalTime, current);
+        }
+        else
+        {
+            do
+            {
+                put = -1;
+                if (arr.arrive[current] <= totalTime && rejectTask(work, arr, policy, live, metrics, current))
+                {
+                    put = 0;                                                // never fits, move on to the next task
+                    current++;
+                }
+                else if (arr.arrive[current] <= totalTime)                  // Only tasks that have arrived
+                {
+                    int units = policy[0].round(arr.size[current]), home = homeOf(arr, current, memory.count), r;
+                    put = findRegion(work, policy, home, units, scan, r);   // Check if item can be placed
+                    HOLES& holes = memory.region[home].holes;
+                    if (put < 0 && work.compact.when == COMPACT_FAIL && holes.total >= units && holes.byAddr.size() > 1
+                        && compact(work, arr, policy, live, metrics, totalTime, home))   // enough room once the holes are joined
+                    {
+                        put = findRegion(work, policy, home, units, scan, r);
+                    }
+                    if (put >= 0)
+                    {
+                        place(work, arr, policy, live, metrics, current, r, put, units, totalTime);
+                        current++;
+                    }
+                    else
+                    {
+                        METRIC(metrics.failed++);
+                    }
+                }
+                if (current == arr.count && trace != nullptr && readTasks(*trace, arr, current))   // window used up, load the next one
+                {
+                    current = 0;
+                }
+            }while(put >= 0 && current < arr.count);                        // Continue while we can place the item
+        }
+        long long step = 1;
+        if (current < arr.count)                                        // Jump to the next release or arrival
+        {
+            step = nextRelease(events, totalTime);
+            int next = work.sched.order == ORDER_FIFO ? current : work.ready.horizon;   // next task to arrive
+            if (next < arr.count && arr.arrive[next] > totalTime)
+            {
+                step = min(step, arr.arrive[next] - totalTime);
+            }
+        }
+        METRIC(sampleMemory(metrics, memory, step));
+        int released = incrementTime(memory, events, policy, totalTime, step);
+        live.resident -= released;
+        live.completed += released;
+    }
+    if (totalTime > 0)                                                  // time weighted metrics become means
+    {
+        metrics.utilization /= totalTime;
+        metrics.external /= totalTime;
+        metrics.holes /= totalTime;
+    }
+    metrics.searchSteps = SEARCH_STEPS - steps;
+    long long biggestTime = live.resident > 0 ? live.lastDue - totalTime : 0;   // the last release drains memory
+    ON_TIMELINE(timelineResident(memory, events));
+    events.clear();
+    totalTime+=biggestTime;
+    metrics.totalTime = totalTime;
+    metrics.waste = live.reserved > 0 ? (double)(live.reserved - live.requested) / live.reserved : 0;
+    rePROCESS(arr);
+    return totalTime;
+}
+/***************************************************************************
+ * long long bestFit (WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: bestfit algorithm that finds the block that is closest to size of the task.
+ * Parameters:
+ * work   I/O   WORKSPACE&   memory to run in
+ * arr    I/P   STREAM&      info stream of tasks to be processed in memory
+ * trace  I/P   TRACE*       trace to replay through arr, or nullptr
+ * scan   I/P   bool         use the bitmap scans of mem instead of the hole index
+ * metrics O/P  METRICS&     what the run measured
+**************************************************************************/
+long long bestFit (WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+{
+    return simulate<BEST_FIT>(work, arr, trace, scan, metrics);
+}
+/***************************************************************************
+ * long long firstFit (WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: firstfit algorithm that finds the first closest block capable of processing the task in memory.
+ * Parameters:
+ * work   I/O   WORKSPACE&   memory to run in
+ * arr    I/P   STREAM&      info stream of tasks to be processed in memory
+ * trace  I/P   TRACE*       trace to replay through arr, or nullptr
+ * scan   I/P   bool         use the bitmap scans of mem instead of the hole index
+ * metrics O/P  METRICS&     what the run measured
+**************************************************************************/
+long long firstFit(WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+{
+    return simulate<FIRST_FIT>(work, arr, trace, scan, metrics);
+}
+/***************************************************************************
+ * long long nextFit (WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: nextFit algorithm that starts each search where the last task was placed.
+ * Parameters:
+ * work   I/O   WORKSPACE&   memory to run in
+ * arr    I/P   STREAM&      info stream of tasks to be processed in memory
+ * trace  I/P   TRACE*       trace to replay through arr, or nullptr
+ * scan   I/P   bool         use the bitmap scans of mem instead of the hole index
+ * metrics O/P  METRICS&     what the run measured
+**************************************************************************/
+long long nextFit(WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+{
+    return simulate<NEXT_FIT>(work, arr, trace, scan, metrics);
+}
+/***************************************************************************
+ * long long worstFit (WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: worstFit algorithm that finds the block that is biggest capable of processing the task.
+ * Parameters:
+ * work   I/O   WORKSPACE&   memory to run in
+ * arr    I/P   STREAM&      info stream of tasks to be processed in memory
+ * trace  I/P   TRACE*       trace to replay through arr, or nullptr
+ * scan   I/P   bool         use the bitmap scans of mem instead of the hole index
+ * metrics O/P  METRICS&     what the run measured
+**************************************************************************/
+long long worstFit(WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+{
+    return simulate<WORST_FIT>(work, arr, trace, scan, metrics);
+}
+/***************************************************************************
+ * long long buddyFit (WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+ * Description: buddy system, tasks take the smallest free power of two block.
+ * Parameters:
+ * work   I/O   WORKSPACE&   memory to run in
+ * arr    I/P   STREAM&      info stream of tasks to be processed in memory
+ * trace  I/P   TRACE*       trace to replay through arr, or nullptr
+ * scan   I/P   bool         use the bitmap scans of mem instead of the hole index
+ * metrics O/P  METRICS&     what the run measured
+**************************************************************************/
+long long buddyFit(WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+{
+    return simulate<BUDDY>(work, arr, trace, scan, metrics);
+}
+/***************************************************************************
+ * long long quickFit (WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+ * Description: quick fit, tasks take a cached block of their size class or a first fit block.
+ * Parameters:
+ * work   I/O   WORKSPACE&   memory to run in
+ * arr    I/P   STREAM&      info stream of tasks to be processed in memory
+ * trace  I/P   TRACE*       trace to replay through arr, or nullptr
+ * scan   I/P   bool         use the bitmap scans of mem instead of the hole index
+ * metrics O/P  METRICS&     what the run measured
+**************************************************************************/
+long long quickFit(WORKSPACE& work, STREAM& arr, TRACE* trace, bool scan, METRICS& metrics)
+{
+    return simulate<QUICK_FIT>(work, arr, trace, scan, metrics);
+}
+/***************************************************************************
+ * int uniform( int lo, int hi, RNG& rng )
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: generates a random uniform value
+ * Scales the top 32 bits of one word by multiplying and shifting, with no
+ * division or rejection loop. The bias is below range / 2^32.
+ * Parameters:
+ * lo     I/P     int    minimum value
+ * hi     I/P     int    maximum value
+ * rng    I/O     RNG&   random number stream of the experiment
+**************************************************************************/
+int uniform( int lo, int hi, RNG& rng )
+{
+    uint64_t range = (uint64_t)(hi - lo) + 1;
+    return lo + (int)(((rng() >> 32) * range) >> 32);
+}
+/***************************************************************************
+ * int normal( int loops, int ulimit, RNG& rng )
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: generates a random normal value
+ * Parameters:
+ * loops     I/P     int    number of loops to run
+ * ulimit    I/P     int
+ * rng       I/O     RNG&   random number stream of the experiment
+**************************************************************************/
+int normal ( int loops, int ulimit, RNG& rng )
+{
+    int x = 0;
+    for( int i=0; i< loops; i++ )
+    {
+        x += uniform( 0, ulimit, rng );
+    }
+    return x;
+}
+/***************************************************************************
+ * long long verifyFit(FIT fit, WORKSPACE& work, STREAM& arr, TRACE* trace, const char* name, METRICS& metrics)
+ * Description: runs an algorithm with the hole index and again with the reference
+ * scans of mem, reports any difference and returns the indexed result. A trace
+ * is also replayed through the smallest stream window the scheduler allows,
+ * which must give the same metrics as arr.
+ * Parameters:
+ * fit    I/P   FIT          algorithm to check
+ * work   I/O   WORKSPACE&   memory to run in
+ * arr    I/P   STREAM&      info stream of tasks to be processed in memory
+ * trace  I/P   TRACE*       trace to replay through arr, or nullptr
+ * name   I/P   const char*  name printed when the results differ
+ * metrics O/P  METRICS&     what the indexed run measured
+**************************************************************************/
+typedef long long (*FIT)(WORKSPACE&, STREAM&, TRACE*, bool, METRICS&);
+const int NUM_FITS = 6;
+const FIT FITS[NUM_FITS] = {bestFit, firstFit, nextFit, worstFit, buddyFit, quickFit};
+const char* const FIT_NAMES[NUM_FITS] = {"BestFit", "FirstFit", "NextFit", "WorstFit", "Buddy", "QuickFit"};
+long long verifyFit(FIT fit, WORKSPACE& work, STREAM& arr, TRACE* trace, const char* name, METRICS& metrics)
+{
+    long long scanned = fit(work, arr, trace, true, metrics);
+    long long indexed = fit(work, arr, trace, false, metrics);
+    if (scanned != indexed)
+    {
+        cerr << " " << name << " mismatch: index " << indexed << " scan " << scanned << endl;
+    }
+    if (trace != nullptr)                                               // the window size must not show in the results
+    {
+        ARENA arena;
+        STREAM narrow;
+        initStream(narrow, arena, work.sched.window + 1);
+        METRICS check;
+        long long narrowed = fit(work, narrow, trace, false, check);
+        if (narrowed != indexed || memcmp(&check, &metrics, sizeof(METRICS)) != 0)
+        {
+            cerr << " " << name << " mismatch: window of " << arr.capacity << " " << indexed
+                 << " window of " << narrow.capacity << " " << narrowed << (narrowed == indexed ? " metrics differ" : "") << endl;
+        }
+    }
+    return indexed;
+}
+/***************************************************************************
+ * struct DIST, POINT, SWEEP
+ * Description: the grid of configurations to run. A DIST draws task sizes or
+ * times, written
+ *   normal:LOOPS:ULIMIT   sum of LOOPS uniform values in 0..ULIMIT (the original generator)
+ *   uniform:LO:HI         uniform integers in LO..HI
+ *   tnormal:MEAN:SD       normal truncated to values that round to 1 or more, MEAN >= 1
+ *   exp:MEAN              exponential
+ *   pareto:XM:ALPHA       Pareto with scale XM and shape ALPHA
+ *   hist:FILE             empirical histogram, "value weight" per line of FILE
+ * Continuous values are rounded, and every value is at least 1. Sizes are not
+ * clamped to memory: exp, pareto and hist have no upper bound short of
+ * DIST_CAP, and a task too big for every block it may go to is rejected and
+ * counted in METRICS.rejected (see rejectTask) rather than resized, so the
+ * distribution stays the one asked for and the tail shows in the count.
+ * A POINT is one memory size, stream length and pair of distributions. SWEEP
+ * holds a list of each, and every combination is a point, with every compaction
+ * trigger (never, fail or frag:X, see COMPACTION) and move cost, and every
+ * scheduler (fifo, backfill or sjf, see SCHEDULER) and lookahead window, and
+ * every number of regions with every spill policy (see WORKSPACE). The aging
+ * bound and SLO are the same at every point. The defaults are the original experiment: 56
+ * units, 1000 tasks, normal(4,4) for both, no compaction, fifo placement, one
+ * region, 1000 trials of every algorithm.
+ * Parameters:
+ * N/A
+**************************************************************************/
+const int DIST_NORMAL = 0;
+const int DIST_UNIFORM = 1;
+const int DIST_TNORMAL = 2;
+const int DIST_EXP = 3;
+const int DIST_PARETO = 4;
+const int DIST_HIST = 5;
+const int NUM_DISTS = 6;
+const char* const DIST_NAMES[NUM_DISTS] = {"normal", "uniform", "tnormal", "exp", "pareto", "hist"};
+const int DIST_CAP = 1 << 30;                         // largest value drawn, keeps heavy tails in an int
+struct DIST
+{
+    int kind = DIST_NORMAL;                           // index into DIST_NAMES
+    double a = 4, b = 4;                              // parameters in the order they are written
+    string path;                                      // histogram file
+    vector<int> value;                                // histogram values
+    vector<double> prob;                              // alias table: chance of keeping value[i] in slot i
+    vector<int> alias;                                // alias table: slot whose value is used otherwise
+};
+struct POINT
+{
+    int memSize;                                      // number of allocation units in memory
+    int tasks;                                        // tasks in the info stream
+    DIST size, time;                                  // distributions of task size and time
+    COMPACTION compact;                               // when memory is compacted and the cost of moving it
+    SCHEDULER sched;                                  // which waiting task is placed next
+    int regions;                                      // number of regions memory is split into
+    int spill;                                        // where a task goes when its region is full
+};
+struct SWEEP
+{
+    vector<int> memSizes = {56};
+    vector<int> tasks = {1000};
+    vector<DIST> sizes = {DIST()};
+    vector<DIST> times = {DIST()};
+    vector<COMPACTION> compacts = {COMPACTION()};
+    vector<double> moveCosts = {0};                   // paired with every compaction trigger but never
+    vector<int> orders = {ORDER_FIFO};                // schedulers, indexes into ORDER_NAMES
+    vector<int> windows = {64};                       // paired with every scheduler but fifo
+    SCHEDULER sched;                                  // aging bound and SLO of every point
+    vector<int> regionCounts = {1};
+    vector<int> spills = {SPILL_NONE};                // paired with every number of regions but 1
+    vector<int> fits;                                 // algorithms to run, indexes into FITS; all when empty
+    int trials = 1000;                                // experiments per point, at most when ci is set
+    double ci = -1;                                   // stop once every 95% interval is within this share of its mean
+    int minTrials = 30;                               // experiments run before stopping early is considered
+    unsigned seed = 1;                                // base seed, experiment i uses (seed, i)
+};
+/***************************************************************************
+ * void fillColumn(int* out, int count, const DIST& dist, RNG& rng)
+ * Description: fills a column of count values from a distribution, GEN_BATCH at
+ * a time. Each batch draws its random words in one call and turns them into
+ * values in loops without branches, which the compiler vectorises. Truncated
+ * normal values below 1 are redrawn one at a time afterwards.
+ * Parameters:
+ * out     O/P   int*          column to fill
+ * count   I/P   int           number of values
+ * dist    I/P   const DIST&   distribution
+ * rng     I/O   RNG&          random number stream of the experiment
+**************************************************************************/
+const int GEN_BATCH = 256;                            // values made per pass
+inline double unitReal(uint64_t bits)                 // (0, 1] from the top 53 bits
+{
+    return (double)((bits >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+void fillColumn(int* out, int count, const DIST& dist, RNG& rng)
+{
+    uint64_t bits[GEN_BATCH], more[GEN_BATCH];
+    double x[GEN_BATCH];
+    for(int base = 0; base < count; base += GEN_BATCH)
+    {
+        int n = min(GEN_BATCH, count - base);
+        int* o = out + base;
+        if (dist.kind == DIST_NORMAL || dist.kind == DIST_UNIFORM)
+        {
+            bool sum = dist.kind == DIST_NORMAL;
+            int loops = sum ? (int)dist.a : 1;
+            int lo = sum ? 0 : (int)dist.a;
+            uint64_t range = (uint64_t)((sum ? (int)dist.b : (int)dist.b - lo) + 1);
+            for(int i=0; i<n; i++)
+            {
+                o[i] = lo;
+            }
+            for(int l=0; l<loops; l++)                                          // one uniform per loop per value
+            {
+                rng.fill(bits, n);
+                for(int i=0; i<n; i++)
+                {
+                    o[i] += (int)(((bits[i] >> 32) * range) >> 32);
+                }
+            }
+        }
+        else if (dist.kind == DIST_HIST)
+        {
+            uint64_t slots = dist.value.size();
+            rng.fill(bits, n);
+            for(int i=0; i<n; i++)                                              // top bits pick a slot, low bits the coin
+            {
+                int slot = (int)(((bits[i] >> 32) * slots) >> 32);
+                double coin = (double)(bits[i] & 0xffffffffULL) * (1.0 / 4294967296.0);
+                o[i] = coin < dist.prob[slot] ? dist.value[slot] : dist.value[dist.alias[slot]];
+            }
+        }
+        else
+        {
+            rng.fill(bits, n);
+            if (dist.kind == DIST_TNORMAL)
+            {
+                rng.fill(more, n);
+                for(int i=0; i<n; i++)                                          // Box-Muller, cosine half
+                {
+                    x[i] = dist.a + dist.b * sqrt(-2 * log(unitReal(bits[i]))) * cos(2 * M_PI * unitReal(more[i]));
+                }
+            }
+            else if (dist.kind == DIST_EXP)
+            {
+                for(int i=0; i<n; i++)
+                {
+                    x[i] = -dist.a * log(unitReal(bits[i]));
+                }
+            }
+            else
+            {
+                for(int i=0; i<n; i++)
+                {
+                    x[i] = dist.a * pow(unitReal(bits[i]), -1 / dist.b);
+                }
+            }
+            for(int i=0; i<n; i++)
+            {
+                o[i] = (int)(min(x[i], (double)DIST_CAP) + 0.5);
+            }
+            for(int i=0; dist.kind == DIST_TNORMAL && i<n; i++)                // redraw what truncation cuts off
+            {
+                while (o[i] < 1)
+                {
+                    double z = sqrt(-2 * log(unitReal(rng()))) * cos(2 * M_PI * unitReal(rng()));
+                    o[i] = (int)(min(dist.a + dist.b * z, (double)DIST_CAP) + 0.5);
+                }
+            }
+        }
+        for(int i=0; i<n; i++)
+        {
+            o[i] = max(o[i], 1);
+        }
+    }
+}
+/***************************************************************************
+ * string distName(const DIST& dist)
+ * Description: writes a distribution the way it is given on the command line.
+ * Parameters:
+ * dist   I/P   const DIST&   distribution
+**************************************************************************/
+string distName(const DIST& dist)
+{
+    if (dist.kind == DIST_HIST)
+    {
+        return "hist:" + dist.path;
+    }
+    char text[96];
+    if (dist.kind == DIST_EXP)
+    {
+        snprintf(text, sizeof(text), "%s:%g", DIST_NAMES[dist.kind], dist.a);
+    }
+    else
+    {
+        snprintf(text, sizeof(text), "%s:%g:%g", DIST_NAMES[dist.kind], dist.a, dist.b);
+    }
+    return text;
+}
+/***************************************************************************
+ * bool readHistogram(DIST& dist)
+ * Description: reads the histogram file of dist, one "value weight" or
+ * "value,weight" per line, and builds its alias table so a value is drawn in
+ * O(1). Lines that do not start with a digit are skipped.
+ * Parameters:
+ * dist   I/O   DIST&   histogram distribution, path set
+**************************************************************************/
+bool readHistogram(DIST& dist)
+{
+    FILE* file = fopen(dist.path.c_str(), "r");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    vector<double> weight;
+    double total = 0;
+    char line[256];
+    dist.value.clear();
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        int value;
+        double w;
+        if (line[0] >= '0' && line[0] <= '9' && sscanf(line, "%d%*[ ,\t]%lf", &value, &w) == 2 && w > 0)
+        {
+            dist.value.push_back(value);
+            weight.push_back(w);
+            total += w;
+        }
+    }
+    fclose(file);
+    int n = dist.value.size();
+    dist.prob.assign(n, 1);
+    dist.alias.assign(n, 0);
+    vector<int> small, large;                                                   // Vose's alias method
+    for(int i=0; i<n; i++)
+    {
+        weight[i] = weight[i] * n / total;
+        (weight[i] < 1 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty())
+    {
+        int s = small.back(), l = large.back();
+        small.pop_back();
+        dist.prob[s] = weight[s];
+        dist.alias[s] = l;
+        weight[l] -= 1 - weight[s];
+        if (weight[l] < 1)
+        {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    return n > 0;
+}
+/***************************************************************************
+ * bool parseDist(const string& text, DIST& dist)
+ * Description: reads a distribution written NAME:A[:B] or hist:FILE. Returns false
+ * if it is not one or its parameters are out of range.
+ * Parameters:
+ * text   I/P   const string&   distribution as written
+ * dist   O/P   DIST&           distribution
+**************************************************************************/
+bool parseDist(const string& text, DIST& dist)
+{
+    if (text.compare(0, 5, "hist:") == 0)
+    {
+        dist.kind = DIST_HIST;
+        dist.path = text.substr(5);
+        return readHistogram(dist);
+    }
+    char name[32];
+    int got = sscanf(text.c_str(), "%31[a-z]:%lf:%lf", name, &dist.a, &dist.b);
+    for(dist.kind = 0; got >= 2 && dist.kind < NUM_DISTS; dist.kind++)
+    {
+        if (DIST_NAMES[dist.kind] != string(name))
+        {
+            continue;
+        }
+        if (dist.kind == DIST_EXP)
+        {
+            return got == 2 && dist.a > 0;
+        }
+        if (got != 3)
+        {
+            return false;
+        }
+        if (dist.kind == DIST_NORMAL)
+        {
+            return dist.a >= 1 && dist.b >= 0 && dist.a == (int)dist.a && dist.b == (int)dist.b;
+        }
+        if (dist.kind == DIST_UNIFORM)
+        {
+            return dist.a <= dist.b && dist.a == (int)dist.a && dist.b == (int)dist.b;
+        }
+        if (dist.kind == DIST_TNORMAL)
+        {
+            return dist.a >= 1 && dist.b > 0;
+        }
+        return dist.kind == DIST_PARETO && dist.a > 0 && dist.b > 0;
+    }
+    return false;
+}
+/***************************************************************************
+ * bool setOption(SWEEP& sweep, const string& key, const string& value)
+ * Description: sets one sweep option from the command line or a config file.
+ * mem, tasks, size, time, compact, movecost and policies take comma separated
+ * lists. ci W reports 95% confidence intervals and stops a point once every
+ * algorithm's is within W times its mean total time (never for 0), checked
+ * after mintrials experiments and every CI_BATCH after that. Reports a bad
+ * key or value and returns false.
+ * Parameters:
+ * sweep   I/O   SWEEP&          sweep to change
+ * key     I/P   const string&   option name
+ * value   I/P   const string&   option value
+**************************************************************************/
+bool setOption(SWEEP& sweep, const string& key, const string& value)
+{
+    vector<string> items;
+    for(size_t start = 0; start <= value.size(); )                              // split the list at commas
+    {
+        size_t end = value.find(',', start);
+        end = end == string::npos ? value.size() : end;
+        items.push_back(value.substr(start, end - start));
+        start = end + 1;
+    }
+    bool ok = true;
+    if (key == "mem" || key == "tasks")
+    {
+        vector<int>& list = key == "mem" ? sweep.memSizes : sweep.tasks;
+        list.clear();
+        for(size_t i=0; i<items.size(); i++)
+        {
+            list.push_back(atoi(items[i].c_str()));
+            ok = ok && list.back() >= 1;
+        }
+    }
+    else if (key == "size" || key == "time")
+    {
+        vector<DIST>& list = key == "size" ? sweep.sizes : sweep.times;
+        list.assign(items.size(), DIST());
+        for(size_t i=0; i<items.size(); i++)
+        {
+            ok = ok && parseDist(items[i], list[i]);
+        }
+    }
+    else if (key == "compact")
+    {
+        sweep.compacts.assign(items.size(), COMPACTION());
+        for(size_t i=0; i<items.size(); i++)
+        {
+            COMPACTION& c = sweep.compacts[i];
+            c.when = items[i] == "fail" ? COMPACT_FAIL : items[i].compare(0, 5, "frag:") == 0 ? COMPACT_FRAG : COMPACT_NEVER;
+            if (c.when == COMPACT_FRAG)
+            {
+                c.threshold = atof(items[i].c_str() + 5);
+            }
+            ok = ok && (c.when != COMPACT_NEVER || items[i] == "never") && c.threshold >= 0 && c.threshold < 1;
+        }
+    }
+    else if (key == "movecost")
+    {
+        sweep.moveCosts.clear();
+        for(size_t i=0; i<items.size(); i++)
+        {
+            sweep.moveCosts.push_back(atof(items[i].c_str()));
+            ok = ok && sweep.moveCosts.back() >= 0;
+        }
+    }
+    else if (key == "sched")
+    {
+        sweep.orders.clear();
+        for(size_t i=0; i<items.size(); i++)
+        {
+            int k = 0;
+            while (k < NUM_ORDERS && items[i] != ORDER_NAMES[k])
+            {
+                k++;
+            }
+            sweep.orders.push_back(k);
+            ok = ok && k < NUM_ORDERS;
+        }
+    }
+    else if (key == "window")
+    {
+        sweep.windows.clear();
+        for(size_t i=0; i<items.size(); i++)
+        {
+            sweep.windows.push_back(atoi(items[i].c_str()));
+            ok = ok && sweep.windows.back() >= 1;
+        }
+    }
+    else if (key == "regions")
+    {
+        sweep.regionCounts.clear();
+        for(size_t i=0; i<items.size(); i++)
+        {
+            sweep.regionCounts.push_back(atoi(items[i].c_str()));
+            ok = ok && sweep.regionCounts.back() >= 1;
+        }
+    }
+    else if (key == "spill")
+    {
+        sweep.spills.clear();
+        for(size_t i=0; i<items.size(); i++)
+        {
+            int k = 0;
+            while (k < NUM_SPILLS && items[i] != SPILL_NAMES[k])
+            {
+                k++;
+            }
+            sweep.spills.push_back(k);
+            ok = ok && k < NUM_SPILLS;
+        }
+    }
+    else if (key == "aging" || key == "slo")
+    {
+        long long& limit = key == "aging" ? sweep.sched.aging : sweep.sched.slo;
+        limit = value == "none" ? LLONG_MAX : atoll(value.c_str());
+        ok = limit >= 0;
+    }
+    else if (key == "policies")
+    {
+        sweep.fits.clear();
+        for(size_t i=0; i<items.size(); i++)
+        {
+            int k = 0;
+            while (k < NUM_FITS && items[i] != FIT_NAMES[k])
+            {
+                k++;
+            }
+            sweep.fits.push_back(k);
+            ok = ok && k < NUM_FITS;
+        }
+    }
+    else if (key == "trials")
+    {
+        sweep.trials = atoi(value.c_str());
+        ok = sweep.trials >= 1;
+    }
+    else if (key == "seed")
+    {
+        sweep.seed = strtoul(value.c_str(), nullptr, 10);
+    }
+    else if (key == "ci")
+    {
+        sweep.ci = atof(value.c_str());
+        ok = sweep.ci >= 0;
+    }
+    else if (key == "mintrials")
+    {
+        sweep.minTrials = atoi(value.c_str());
+        ok = sweep.minTrials >= 2;
+    }
+    else
+    {
+        cerr << " unknown option " << key << endl;
+        return false;
+    }
+    if (!ok)
+    {
+        cerr << " bad value for " << key << ": " << value << endl;
+    }
+    return ok;
+}
+/***************************************************************************
+ * bool readConfig(SWEEP& sweep, const char* path)
+ * Description: reads sweep options from a file, one "key = value" per line
+ * with the same keys as the command line. Blank lines and lines starting with
+ * # are skipped, spaces are ignored.
+ * Parameters:
+ * sweep   I/O   SWEEP&        sweep to change
+ * path    I/P   const char*   config file
+**************************************************************************/
+bool readConfig(SWEEP& sweep, const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (file == nullptr)
+    {
+        cerr << " cannot open config " << path << endl;
+        return false;
+    }
+    bool ok = true;
+    char line[1024];
+    while (ok && fgets(line, sizeof(line), file) != nullptr)
+    {
+        string text;
+        for(char* c = line; *c != '\0' && *c != '#'; c++)                       // drop spaces and comments
+        {
+            if (!isspace((unsigned char)*c))
+            {
+                text += *c;
+            }
+        }
+        size_t equals = text.find('=');
+        if (!text.empty())
+        {
+            ok = equals != string::npos && setOption(sweep, text.substr(0, equals), text.substr(equals + 1));
+            if (equals == string::npos)
+            {
+                cerr << " config line without '=': " << line;
+            }
+        }
+    }
+    fclose(file);
+    return ok;
+}
+/***************************************************************************
+ * string compactName(const COMPACTION& compact)
+ * Description: writes a compaction trigger the way it is given on the command line.
+ * Parameters:
+ * compact   I/P   const COMPACTION&   compaction settings
+**************************************************************************/
+string compactName(const COMPACTION& compact)
+{
+    if (compact.when == COMPACT_FRAG)
+    {
+        ostringstream text;
+        text << "frag:" << compact.threshold;
+        return text.str();
+    }
+    return compact.when == COMPACT_FAIL ? "fail" : "never";
+}
+/***************************************************************************
+ * string limitName(long long ticks)
+ * Description: writes an aging bound or SLO the way it is given on the command line.
+ * Parameters:
+ * ticks   I/P   long long   limit in clock ticks, LLONG_MAX for none
+**************************************************************************/
+string limitName(long long ticks)
+{
+    return ticks == LLONG_MAX ? "none" : to_string(ticks);
+}
+/***************************************************************************
+ * string pointName(const POINT& point, const char* trace)
+ * Description: one line description of a point of the grid. A replayed trace
+ * takes the place of the stream length and distributions.
+ * Parameters:
+ * point   I/P   const POINT&   point of the grid
+ * trace   I/P   const char*    trace file, or nullptr
+**************************************************************************/
+string pointName(const POINT& point, const char* trace)
+{
+    ostringstream text;
+    text << "mem=" << point.memSize;
+    if (trace != nullptr)
+    {
+        text << " trace=" << trace;
+    }
+    else
+    {
+        text << " tasks=" << point.tasks << " size=" << distName(point.size) << " time=" << distName(point.time);
+    }
+    if (point.compact.when != COMPACT_NEVER)
+    {
+        text << " compact=" << compactName(point.compact) << " movecost=" << point.compact.moveCost;
+    }
+    if (point.sched.order != ORDER_FIFO)
+    {
+        text << " sched=" << ORDER_NAMES[point.sched.order] << " window=" << point.sched.window
+             << " aging=" << limitName(point.sched.aging);
+    }
+    if (point.sched.slo != LLONG_MAX)
+    {
+        text << " slo=" << point.sched.slo;
+    }
+    if (point.regions > 1)
+    {
+        text << " regions=" << point.regions << " spill=" << SPILL_NAMES[point.spill];
+    }
+    return text.str();
+}
+/***************************************************************************
+ * void makeStream(STREAM& stream, const POINT& point, unsigned seed, int trial)
+ * Description: populates the info stream of one experiment from its own seed,
+ * so the same (seed, trial) always gives the same tasks. Sizes and times are
+ * made a column at a time. With regions, each task prefers one drawn uniformly,
+ * after the sizes and times, so one region leaves the stream as it was.
+ * Parameters:
+ * stream   O/P   STREAM&        info stream to fill
+ * point    I/P   const POINT&   distributions of size and time
+ * seed     I/P   unsigned       base seed
+ * trial    I/P   int            experiment number
+**************************************************************************/
+void makeStream(STREAM& stream, const POINT& point, unsigned seed, int trial)
+{
+    RNG rng;
+    seedRng(rng, seed, trial);
+    fillColumn(stream.size, stream.count, point.size, rng);            // Generate Task Info Stream
+    fillColumn(stream.oTime, stream.count, point.time, rng);
+    memset(stream.arrive, 0, stream.count * sizeof(long long));        // every task is there from the start
+    for(int i=0; i<stream.count; i++)
+    {
+        stream.region[i] = point.regions > 1 ? uniform(0, point.regions - 1, rng) : 0;
+    }
+    rePROCESS(stream);
+}
+/***************************************************************************
+ * struct RUNNER
+ * Description: experiments of one point shared between the worker threads.
+ * Workers claim the next experiment from a shared counter and add into their
+ * own totals, which runPoint sums once every worker has finished. When metrics
+ * are written or checkpointed every run is also kept, indexed by experiment and
+ * algorithm, and the sums are taken from it in experiment order so they do not
+ * depend on which worker ran what. With confidence intervals the experiments
+ * run in batches, and after each batch its runs are added to the running
+ * statistics in experiment order: the total time of each algorithm, and its
+ * difference from the first algorithm on the same stream. Where a point stops
+ * depends only on the seed, never on the number of workers.
+ * Each worker's stream, arena and workspace outlive the point, so the next
+ * point of the grid reuses them and only grows them when it needs more room.
+ * Parameters:
+ * N/A
+**************************************************************************/
+struct TOTALS
+{
+    alignas(64) METRICS sum[NUM_FITS];                // per worker sum of each algorithm, own cache lines
+};
+struct WORKER
+{
+    TOTALS totals;                                    // sums of the current point
+    ARENA arena;                                      // holds the stream columns
+    STREAM stream;                                    // info stream of the experiment being run
+    WORKSPACE work;                                   // memory the algorithms run in
+};
+const int CI_BATCH = 64;                              // experiments run between checks of the intervals
+struct RUNNER
+{
+    atomic<int> next{0};                              // next experiment to claim
+    int limit = 0;                                    // end of the batch being claimed
+    POINT point;                                      // configuration being run
+    int trials = 1000;                                // number of experiments, the number run once the point is done
+    double ci = -1;                                   // target width of the intervals, below 0 for none
+    int minTrials = 30;                               // experiments before the first check
+    STATS time[NUM_FITS];                             // total time of each algorithm
+    STATS diff[NUM_FITS];                             // its total time less the first algorithm's on the same stream
+    unsigned seed = 1;                                // base seed, experiment i uses (seed, i)
+    bool verify = false;                              // check the hole index against the scans
+    bool keep = false;                                // keep the metrics of every run
+    vector<int> fits;                                 // algorithms to run
+    vector<WORKER> workers;                           // one entry per worker thread
+    vector<METRICS> results;                          // metrics of experiment i, algorithm k at i * NUM_FITS + k
+    vector<atomic<char>> done;                        // experiment i has run every algorithm
+    CHECKPOINT* checkpoint = nullptr;                 // checkpoints of the run, or nullptr
+};
+/***************************************************************************
+ * void saveTrials(RUNNER& run)
+ * Description: checkpoints the point being run: the experiments every
+ * algorithm has finished and their metrics. Called by worker 0 while the
+ * others carry on.
+ * Parameters:
+ * run   I/O   RUNNER&   experiments of the point
+**************************************************************************/
+void saveTrials(RUNNER& run)
+{
+    SNAPSHOT& out = beginCheckpoint(*run.checkpoint);
+    vector<int> done;
+    for(int i=0; i<run.trials; i++)
+    {
+        if (run.done[i])
+        {
+            done.push_back(i);
+        }
+    }
+    putValue(out, PROGRESS_TRIALS);
+    putVector(out, done);
+    for(size_t d=0; d<done.size(); d++)
+    {
+        putBytes(out, &run.results[done[d] * NUM_FITS], NUM_FITS * sizeof(METRICS));
+    }
+    commitCheckpoint(*run.checkpoint);
+}
+/***************************************************************************
+ * bool resuming(CHECKPOINT* cp, int kind)
+ * Description: true when the checkpoint being resumed still holds the progress
+ * of a point, which must be of the given kind. The kind is read past.
+ * Parameters:
+ * cp     I/O   CHECKPOINT*   checkpoints of the run, or nullptr
+ * kind   I/P   int           PROGRESS_TRIALS or PROGRESS_TRACE
+**************************************************************************/
+bool resuming(CHECKPOINT* cp, int kind)
+{
+    if (cp == nullptr || cp->resume.pos >= cp->resume.data.size())
+    {
+        return false;
+    }
+    int found = 0;
+    getValue(cp->resume, found);
+    if (found != kind)
+    {
+        cerr << " checkpoint is damaged" << endl;
+        exit(1);
+    }
+    return true;
+}
+/***************************************************************************
+ * void runTrials(RUNNER& run, int worker)
+ * Description: worker thread, generates the info stream of each claimed experiment
+ * from its own seed and runs all the algorithms on it. Results do not depend on
+ * which worker runs which experiment.
+ * Parameters:
+ * run      I/O   RUNNER&   shared experiment state
+ * worker   I/P   int       index of this worker
+**************************************************************************/
+void runTrials(RUNNER& run, int worker)
+{
+    WORKER& self = run.workers[worker];
+    self.work.memSize = run.point.memSize;
+    self.work.compact = run.point.compact;
+    self.work.sched = run.point.sched;
+    self.work.regions = run.point.regions;
+    self.work.spill = run.point.spill;
+    initStream(self.stream, self.arena, run.point.tasks);
+    for(int i = run.next++; i < run.limit; i = run.next++)               // claim experiments until the batch is done
+    {
+        if (run.done[i])                                                // finished before the run was resumed
+        {
+            continue;
+        }
+        makeStream(self.stream, run.point, run.seed, i);
+        for(size_t f=0; f<run.fits.size(); f++)                         // every algorithm on the same stream
+        {
+            int k = run.fits[f];
+            METRICS metrics;
+            ON_TIMELINE(timelineRun(k, i));
+            if (run.verify)
+            {
+                verifyFit(FITS[k], self.work, self.stream, nullptr, FIT_NAMES[k], metrics);
+            }
+            else
+            {
+                FITS[k](self.work, self.stream, nullptr, SCAN_MEM, metrics);
+            }
+            addMetrics(self.totals.sum[k], metrics);
+            if (run.keep)
+            {
+                run.results[i * NUM_FITS + k] = metrics;
+            }
+        }
+        run.done[i] = 1;
+        if (worker == 0 && run.checkpoint != nullptr && checkpointDue(*run.checkpoint))
+        {
+            saveTrials(run);
+        }
+    }
+}
+/***************************************************************************
+ * void runPoint(RUNNER& run, METRICS sum[])
+ * Description: runs the experiments of run.point on every worker, the calling
+ * thread being worker 0, and sums the workers' totals. Experiments a resumed
+ * checkpoint has already done are not run again. With run.ci set it runs
+ * batches until every interval is narrow enough or run.trials are done, and
+ * sets run.trials to the number run.
+ * Parameters:
+ * run   I/O   RUNNER&     experiments of the point
+ * sum   O/P   METRICS[]   metrics total of each algorithm
+**************************************************************************/
+void runPoint(RUNNER& run, METRICS sum[])
+{
+    run.next = 0;
+    run.done = vector<atomic<char>>(run.trials);
+    if (run.keep)
+    {
+        run.results.assign(run.trials * NUM_FITS, METRICS());
+    }
+    if (resuming(run.checkpoint, PROGRESS_TRIALS))                      // pick up the experiments done before
+    {
+        SNAPSHOT& in = run.checkpoint->resume;
+        vector<int> done;
+        getVector(in, done);
+        for(size_t d=0; d<done.size() && !in.bad; d++)
+        {
+            if (done[d] < 0 || done[d] >= run.trials)
+            {
+                in.bad = true;
+                break;
+            }
+            getBytes(in, &run.results[done[d] * NUM_FITS], NUM_FITS * sizeof(METRICS));
+            run.done[done[d]] = 1;
+        }
+        if (in.bad)
+        {
+            cerr << " checkpoint is damaged" << endl;
+            exit(1);
+        }
+        in.data.clear();
+        in.pos = 0;
+    }
+    for(size_t t=0; t<run.workers.size(); t++)
+    {
+        run.workers[t].totals = TOTALS();
+    }
+    for(int k=0; k<NUM_FITS; k++)
+    {
+        run.time[k] = run.diff[k] = STATS();
+    }
+    int from = 0;
+    run.limit = run.ci < 0 ? run.trials : min(run.trials, run.minTrials);
+    while (from < run.trials)                                           // one batch at a time
+    {
+        run.next = from;
+        vector<thread> threads;
+        for(size_t t=1; t<run.workers.size(); t++)
+        {
+            threads.push_back(thread(runTrials, ref(run), t));
+        }
+        runTrials(run, 0);
+        for(size_t t=0; t<threads.size(); t++)
+        {
+            threads[t].join();
+        }
+        for(; from < run.limit; from++)                                 // statistics in experiment order
+        {
+            for(size_t f=0; run.ci >= 0 && f<run.fits.size(); f++)
+            {
+                long long time = run.results[from * NUM_FITS + run.fits[f]].totalTime;
+                addSample(run.time[run.fits[f]], time);
+                addSample(run.diff[run.fits[f]], time - run.results[from * NUM_FITS + run.fits[0]].totalTime);
+            }
+        }
+        bool narrow = run.ci > 0;
+        for(size_t f=0; narrow && f<run.fits.size(); f++)
+        {
+            narrow = ciHalf(run.time[run.fits[f]]) <= run.ci * fabs(run.time[run.fits[f]].mean);
+        }
+        if (narrow)
+        {
+            break;
+        }
+        run.limit = min(run.trials, run.limit + CI_BATCH);
+    }
+    run.trials = from;
+    if (run.keep)
+    {
+        run.results.resize(run.trials * NUM_FITS);
+    }
+    for(int i=0; run.keep && i<run.trials; i++)                         // sum every run in experiment order
+    {
+        for(size_t f=0; f<run.fits.size(); f++)
+        {
+            addMetrics(sum[run.fits[f]], run.results[i * NUM_FITS + run.fits[f]]);
+        }
+    }
+    for(size_t t=0; !run.keep && t<run.workers.size(); t++)             // or the totals of every worker
+    {
+        for(int k=0; k<NUM_FITS; k++)
+        {
+            addMetrics(sum[k], run.workers[t].totals.sum[k]);
+        }
+    }
+}
+/***************************************************************************
+ * bool replayTrace(WORKER& worker, const char* path, RUNNER& run, METRICS sum[])
+ * Description: replays a workload file once through every algorithm with
+ * run.point.memSize units. Only a window of TRACE_WINDOW tasks, or twice the
+ * scheduler's lookahead if that is more, is held in memory at a time. When checkpointing, the algorithms finished and their
+ * metrics are the context of every checkpoint simulate takes, and a resumed
+ * replay starts again inside the algorithm that was running.
+ * Parameters:
+ * worker  I/O   WORKER&       stream and workspace to use
+ * path    I/P   const char*   trace file
+ * run     I/P   RUNNER&       point, algorithms, whether to verify and checkpoints
+ * sum     O/P   METRICS[]     metrics of each algorithm
+**************************************************************************/
+bool replayTrace(WORKER& worker, const char* path, RUNNER& run, METRICS sum[])
+{
+    TRACE trace;
+    if (!openTrace(trace, path))
+    {
+        cerr << " cannot open trace " << path << endl;
+        return false;
+    }
+    worker.work.memSize = run.point.memSize;
+    worker.work.compact = run.point.compact;
+    worker.work.sched = run.point.sched;
+    worker.work.regions = run.point.regions;
+    worker.work.spill = run.point.spill;
+    initStream(worker.stream, worker.arena, max(TRACE_WINDOW, 2 * (run.point.sched.window + 1)));
+    CHECKPOINT* cp = run.verify ? nullptr : run.checkpoint;             // verifying runs each algorithm twice
+    int from = 0;
+    if (resuming(cp, PROGRESS_TRACE))                                   // algorithms done and the state of the next
+    {
+        getValue(cp->resume, from);
+        getBytes(cp->resume, sum, NUM_FITS * sizeof(METRICS));
+        if (cp->resume.bad || from < 0 || from >= (int)run.fits.size())
+        {
+            cerr << " checkpoint is damaged" << endl;
+            exit(1);
+        }
+        worker.work.restore = &cp->resume;
+    }
+    for(size_t f=from; f<run.fits.size(); f++)
+    {
+        int k = run.fits[f];
+        if (cp != nullptr)
+        {
+            cp->context.data.clear();
+            putValue(cp->context, PROGRESS_TRACE);
+            putValue(cp->context, (int)f);
+            putBytes(cp->context, sum, NUM_FITS * sizeof(METRICS));
+            worker.work.checkpoint = cp;
+        }
+        ON_TIMELINE(timelineRun(k, 0));
+        if (run.verify)
+        {
+            verifyFit(FITS[k], worker.work, worker.stream, &trace, FIT_NAMES[k], sum[k]);
+        }
+        else
+        {
+            FITS[k](worker.work, worker.stream, &trace, SCAN_MEM, sum[k]);
+        }
+        if (cp != nullptr && f == (size_t)from)                         // the checkpoint is used up
+        {
+            cp->resume.data.clear();
+            cp->resume.pos = 0;
+        }
+    }
+    worker.work.checkpoint = nullptr;
+    fclose(trace.file);
+    return true;
+}
+/***************************************************************************
+ * void savePoint(CHECKPOINT& cp, RUNNER& run, METRICS sum[], bool runs)
+ * void readPoint(CHECKPOINT& cp, RUNNER& run, METRICS sum[])
+ * Description: adds the results of a finished point to what every later
+ * checkpoint holds: the number of experiments, the sum and statistics of each
+ * algorithm and, when they are written out, the metrics of every run. readPoint reads them
+ * back from the checkpoint being resumed in place of running the point.
+ * Parameters:
+ * cp     I/O   CHECKPOINT&   checkpoints of the run
+ * run    I/O   RUNNER&       trials and results of the point
+ * sum    I/O   METRICS[]     metrics total of each algorithm
+ * runs   I/P   bool          keep the metrics of every run as well
+**************************************************************************/
+void savePoint(CHECKPOINT& cp, RUNNER& run, METRICS sum[], bool runs)
+{
+    putValue(cp.finished, run.trials);
+    putBytes(cp.finished, sum, NUM_FITS * sizeof(METRICS));
+    putBytes(cp.finished, run.time, sizeof(run.time));
+    putBytes(cp.finished, run.diff, sizeof(run.diff));
+    putVector(cp.finished, runs ? run.results : vector<METRICS>());
+    cp.points++;
+}
+void readPoint(CHECKPOINT& cp, RUNNER& run, METRICS sum[])
+{
+    getValue(cp.resume, run.trials);
+    getBytes(cp.resume, sum, NUM_FITS * sizeof(METRICS));
+    getBytes(cp.resume, run.time, sizeof(run.time));
+    getBytes(cp.resume, run.diff, sizeof(run.diff));
+    getVector(cp.resume, run.results);
+    if (cp.resume.bad)
+    {
+        cerr << " checkpoint is damaged" << endl;
+        exit(1);
+    }
+}
+/***************************************************************************
+ * struct BENCH_MEMORY
+ * Description: memory laid out in one occupancy pattern for the benchmarks,
+ * with the spots where resident tasks can be placed without disturbing it.
+ * Patterns are "empty", "fragmented" (a one unit hole after every three used
+ * units and one 8 unit hole at the end, the worst case for a search) and
+ * "random" (runs of normal(4,4) units, each used with probability one half).
+ * Parameters:
+ * N/A
+**************************************************************************/
+const int BENCH_SIZES[] = {56, 4096, 262144, 10000000};
+const int NUM_PATTERNS = 3;
+const char* const PATTERN_NAMES[NUM_PATTERNS] = {"empty", "fragmented", "random"};
+const int BENCH_REQUEST = 8;                          // units asked for by the search benchmarks
+const int BENCH_BATCH = 4096;                         // resident tasks placed or released per timed batch
+double BENCH_SECONDS = 0.2;                           // minimum time each benchmark runs for
+long long BENCH_SINK = 0;                             // search results go here so they are not optimised away
+struct BENCH_MEMORY
+{
+    MEMORY memory;                                    // one region in the pattern
+    vector<pair<int,int>> spots;                      // start and units of up to BENCH_BATCH free extents
+    ARENA arena;                                      // holds tasks, one per spot
+    STREAM tasks;
+};
+/***************************************************************************
+ * void fillMemory(BENCH_MEMORY& bench, int memSize, int pattern)
+ * Description: lays out memSize units in the given pattern and picks the spots,
+ * up to 4 units at the start of each hole.
+ * Parameters:
+ * bench     O/P   BENCH_MEMORY&   memory to lay out
+ * memSize   I/P   int             number of allocation units in memory
+ * pattern   I/P   int             index into PATTERN_NAMES
+**************************************************************************/
+void fillMemory(BENCH_MEMORY& bench, int memSize, int pattern)
+{
+    initMemory(bench.memory, memSize, 1);
+    RNG rng;
+    seedRng(rng, memSize, pattern);
+    for(int i = 0; pattern > 0 && i < memSize - BENCH_REQUEST; )
+    {
+        int len = pattern == 1 ? 3 : max(1, normal(4,4,rng));
+        len = min(len, memSize - BENCH_REQUEST - i);
+        if (pattern == 1 || uniform(0, 1, rng) == 1)
+        {
+            takeUnits(bench.memory.region[0].mem, bench.memory.region[0].holes, i, len);
+        }
+        i += len + (pattern == 1 ? 1 : 0);
+    }
+    bench.spots.clear();
+    for(map<int,int>::iterator it = bench.memory.region[0].holes.byAddr.begin();
+        it != bench.memory.region[0].holes.byAddr.end() && bench.spots.size() < (size_t)BENCH_BATCH; it++)
+    {
+        bench.spots.push_back(make_pair(it->first, min(it->second, 4)));
+    }
+    initStream(bench.tasks, bench.arena, bench.spots.size());
+    for(size_t j=0; j<bench.spots.size(); j++)
+    {
+        bench.tasks.size[j] = bench.tasks.oTime[j] = bench.spots[j].second;
+        bench.tasks.arrive[j] = 0;
+    }
+    rePROCESS(bench.tasks);
+}
+/***************************************************************************
+ * double benchSearchArr, benchSmallest, benchBiggest, benchFirstHole,
+ *        benchSmallestHole, benchBiggestHole (BENCH_MEMORY& bench, long long ops)
+ * Description: run a search for BENCH_REQUEST units ops times and return the
+ * nanoseconds taken. The bitmap scans and the hole index lookups that stand in
+ * for them are timed side by side.
+ * Parameters:
+ * bench   I/P   BENCH_MEMORY&   memory to search
+ * ops     I/P   long long       number of searches
+**************************************************************************/
+double sinceNs(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+double benchSearchArr(BENCH_MEMORY& bench, long long ops)
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(long long i=0; i<ops; i++)
+    {
+        BENCH_SINK += searchArr(bench.memory.region[0].mem, 0, BENCH_REQUEST);
+    }
+    return sinceNs(start);
+}
+double benchSmallest(BENCH_MEMORY& bench, long long ops)
+{
+    int index, indexSize;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(long long i=0; i<ops; i++)
+    {
+        smallest(bench.memory.region[0].mem, index, indexSize, BENCH_REQUEST);
+        BENCH_SINK += index;
+    }
+    return sinceNs(start);
+}
+double benchBiggest(BENCH_MEMORY& bench, long long ops)
+{
+    int index, indexSize;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(long long i=0; i<ops; i++)
+    {
+        biggest(bench.memory.region[0].mem, index, indexSize, BENCH_REQUEST);
+        BENCH_SINK += index;
+    }
+    return sinceNs(start);
+}
+double benchFirstHole(BENCH_MEMORY& bench, long long ops)
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(long long i=0; i<ops; i++)
+    {
+        BENCH_SINK += firstHole(bench.memory.region[0].holes, 0, BENCH_REQUEST);
+    }
+    return sinceNs(start);
+}
+double benchSmallestHole(BENCH_MEMORY& bench, long long ops)
+{
+    int index, indexSize;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(long long i=0; i<ops; i++)
+    {
+        smallestHole(bench.memory.region[0].holes, index, indexSize, BENCH_REQUEST);
+        BENCH_SINK += index;
+    }
+    return sinceNs(start);
+}
+double benchBiggestHole(BENCH_MEMORY& bench, long long ops)
+{
+    int index, indexSize;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(long long i=0; i<ops; i++)
+    {
+        biggestHole(bench.memory.region[0].holes, index, indexSize, BENCH_REQUEST);
+        BENCH_SINK += index;
+    }
+    return sinceNs(start);
+}
+/***************************************************************************
+ * double benchAddToMem(BENCH_MEMORY& bench, long long ops)
+ * Description: places ops tasks with addToMem, a batch of one task per spot at
+ * a time, and returns the nanoseconds taken. Clearing the owners and the release
+ * queue between batches is not timed.
+ * Parameters:
+ * bench   I/O   BENCH_MEMORY&   memory to place into
+ * ops     I/P   long long       number of placements
+**************************************************************************/
+double benchAddToMem(BENCH_MEMORY& bench, long long ops)
+{
+    double ns = 0;
+    EVENTS events;
+    int batch = bench.spots.size();
+    for(long long done = 0; done < ops; done += batch)
+    {
+        int n = min((long long)batch, ops - done);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for(int j=0; j<n; j++)
+        {
+            addToMem(bench.memory.region[0].mem, events, bench.tasks, j, bench.spots[j].first, bench.spots[j].second, done, 0);
+        }
+        ns += sinceNs(start);
+        bench.memory.region[0].mem.owner.clear();
+        events = EVENTS();
+        rePROCESS(bench.tasks);
+    }
+    return ns;
+}
+/***************************************************************************
+ * double benchIncrementTime(BENCH_MEMORY& bench, long long ops)
+ * Description: moves the clock ops ticks one at a time with one resident task
+ * released on every tick, and returns the nanoseconds taken. The residents of
+ * each batch are placed untimed in the spots, so every batch leaves memory in
+ * the pattern it found it in.
+ * Parameters:
+ * bench   I/O   BENCH_MEMORY&   memory to release from
+ * ops     I/P   long long       number of ticks
+**************************************************************************/
+double benchIncrementTime(BENCH_MEMORY& bench, long long ops)
+{
+    double ns = 0;
+    EVENTS events;
+    FIT_POLICY policy;
+    long long totalTime = 0;
+    int batch = bench.spots.size();
+    for(long long done = 0; done < ops; done += batch)
+    {
+        int n = min((long long)batch, ops - done);
+        for(int j=0; j<n; j++)
+        {
+            policy.placed(bench.memory.region[0].mem, bench.memory.region[0].holes, bench.spots[j].first, bench.spots[j].second);
+            bench.memory.region[0].mem.owner[bench.spots[j].first] = j;
+            RELEASE release = {totalTime + j + 1, bench.spots[j].first, bench.spots[j].second, 0};
+            events.push(release);
+        }
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for(int j=0; j<n; j++)
+        {
+            incrementTime(bench.memory, events, &policy, totalTime, 1);
+        }
+        ns += sinceNs(start);
+    }
+    return ns;
+}
+/***************************************************************************
+ * long long benchRun(double (*run)(BENCH_MEMORY&, long long), BENCH_MEMORY& bench, double& ns)
+ * Description: runs a benchmark with more and more operations until it takes at
+ * least BENCH_SECONDS, the way Google Benchmark picks its iteration count,
+ * after one untimed warm-up operation. Returns the number of operations and their
+ * mean time in ns.
+ * Parameters:
+ * run     I/P   function         benchmark, returns the ns taken by ops operations
+ * bench   I/O   BENCH_MEMORY&    memory it runs on
+ * ns      O/P   double&          nanoseconds per operation
+**************************************************************************/
+long long benchRun(double (*run)(BENCH_MEMORY&, long long), BENCH_MEMORY& bench, double& ns)
+{
+    long long ops = 1;
+    run(bench, 1);
+    while (true)
+    {
+        double taken = run(bench, ops);
+        if (taken >= BENCH_SECONDS * 1e9 || ops >= (1LL << 32))
+        {
+            ns = taken / ops;
+            return ops;
+        }
+        double scale = taken > 0 ? BENCH_SECONDS * 1e9 / taken * 1.4 : 100;
+        ops = max(ops + 1, (long long)(ops * min(scale, 100.0)));
+    }
+}
+/***************************************************************************
+ * void benchLine(const string& name, double ns, const char* unit, long long ops)
+ * Description: prints one row of the benchmark table.
+ * Parameters:
+ * name   I/P   const string&   benchmark name
+ * ns     I/P   double          nanoseconds per unit
+ * unit   I/P   const char*     what was timed
+ * ops    I/P   long long       number of iterations
+**************************************************************************/
+void benchLine(const string& name, double ns, const char* unit, long long ops)
+{
+    cout << left << setw(40) << name << right << setw(14) << fixed << setprecision(1) << ns
+         << " ns/" << left << setw(10) << unit << right << setw(12) << ops << endl;
+}
+/***************************************************************************
+ * void runBenchmarks(const string& filter, const POINT& point)
+ * Description: times the searches, addToMem and incrementTime on every memory
+ * size and occupancy pattern, then every algorithm end to end over fixed seeded
+ * streams of the given point and the generation of those streams, and prints
+ * ns per operation. Only benchmarks whose
+ * name contains filter are run. Names are function/pattern/size, fit/e2e and
+ * makeStream/gen.
+ * Parameters:
+ * filter   I/P   const string&   part of the names of the benchmarks to run
+ * point    I/P   const POINT&    configuration of the end to end runs
+**************************************************************************/
+void runBenchmarks(const string& filter, const POINT& point)
+{
+    struct MICRO { const char* name; double (*run)(BENCH_MEMORY&, long long); const char* unit; };
+    const MICRO micro[] = {{"searchArr", benchSearchArr, "search"}, {"smallest", benchSmallest, "search"},
+                           {"biggest", benchBiggest, "search"}, {"firstHole", benchFirstHole, "search"},
+                           {"smallestHole", benchSmallestHole, "search"}, {"biggestHole", benchBiggestHole, "search"},
+                           {"addToMem", benchAddToMem, "placement"}, {"incrementTime", benchIncrementTime, "tick"}};
+#ifdef __GLIBC__
+    mallopt(M_MXFAST, 0);                   // millions of hole nodes freed between layouts would otherwise sit in the
+#endif                                      // fast bins and be consolidated in the middle of a later timed batch
+    cout << left << setw(40) << "Benchmark" << right << setw(14) << "Time" << "    " << left << setw(10) << "Unit"
+         << right << setw(12) << "Iterations" << endl;
+    BENCH_MEMORY bench;
+    for(int size : BENCH_SIZES)
+    {
+        for(int p=0; p<NUM_PATTERNS; p++)
+        {
+            bool laid = false;                                          // lay out memory only when something runs on it
+            for(const MICRO& m : micro)
+            {
+                string name = string(m.name) + "/" + PATTERN_NAMES[p] + "/" + to_string(size);
+                if (name.find(filter) == string::npos)
+                {
+                    continue;
+                }
+                if (!laid)
+                {
+                    fillMemory(bench, size, p);
+                    laid = true;
+                }
+                double ns;
+                long long ops = benchRun(m.run, bench, ns);
+                benchLine(name, ns, m.unit, ops);
+            }
+        }
+    }
+    const int streams = 16;                                             // end to end runs use experiments 0..15 of seed 1
+    ARENA arena;
+    STREAM stream;
+    initStream(stream, arena, point.tasks);
+    WORKSPACE work;
+    work.memSize = point.memSize;
+    for(int k=0; k<NUM_FITS; k++)
+    {
+        string name = string(FIT_NAMES[k]) + "/e2e";
+        if (name.find(filter) == string::npos)
+        {
+            continue;
+        }
+        long long runs = 0, ticks = 0;
+        double ns = 0;
+        while (ns < BENCH_SECONDS * 1e9)
+        {
+            makeStream(stream, point, 1, runs % streams);
+            METRICS metrics;
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            ticks += FITS[k](work, stream, nullptr, SCAN_MEM, metrics);
+            ns += sinceNs(start);
+            runs++;
+        }
+        benchLine(name, ns / (runs * point.tasks), "placement", runs);
+        benchLine(name, ns / ticks, "tick", runs);
+    }
+    if (string("makeStream/gen").find(filter) != string::npos)           // workload generation on its own
+    {
+        long long runs = 0;
+        double ns = 0;
+        while (ns < BENCH_SECONDS * 1e9)
+        {
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            makeStream(stream, point, 1, runs);
+            ns += sinceNs(start);
+            BENCH_SINK += stream.size[0];
+            runs++;
+        }
+        benchLine("makeStream/gen", ns / (runs * point.tasks), "task", runs);
+    }
+}
+/***************************************************************************
+ * struct STRESS, STRESS_THREAD
+ * Description: a placement policy driven as a real allocator over a shared
+ * arena of STRESS_UNIT_BYTES bytes per unit. Memory is split into regions as
+ * in simulate, each behind its own lock with its own instance of the policy,
+ * so threads whose home regions differ do not contend. A thread tries its home
+ * region first and then the others in turn. Every thread keeps back up to
+ * STRESS_CACHE_BLOCKS of the blocks it frees per size up to STRESS_CACHE_UNITS
+ * units and hands them out again without taking a lock, and gives them all back
+ * when an allocation finds no room. Sizes come from the point's size
+ * distribution, and a block is freed after the number of the thread's own
+ * operations drawn from its time distribution. Blocks are filled when
+ * allocated and checked when freed, so a block handed to two threads at once
+ * shows up as an overlap.
+ * Parameters:
+ * N/A
+**************************************************************************/
+const int STRESS_UNIT_BYTES = 64;                     // bytes of arena behind each allocation unit
+const int STRESS_CACHE_UNITS = 16;                    // blocks up to this many units are cached by the thread freeing them
+const int STRESS_CACHE_BLOCKS = 32;                   // blocks each thread caches per size
+const int LATENCY_BUCKETS = 8 * 62;                   // 8 buckets per power of two up to 2^63 ns
+double STRESS_SECONDS = 1;                            // time each algorithm is run for
+struct REGION_LOCK
+{
+    alignas(64) mutex lock;                           // guards one region and its policy, own cache line
+};
+struct STRESS_THREAD
+{
+    alignas(64) long long ops = 0;                    // allocations and frees done
+    long long allocs = 0;                             // allocations asked for
+    long long failed = 0;                             // allocations no region had room for
+    long long cached = 0;                             // allocations served from the thread's cache
+    long long locked = 0;                             // region locks taken
+    long long contended = 0;                          // of those, locks another thread was holding
+    long long overlaps = 0;                           // freed blocks another allocation wrote over
+    long long latency[LATENCY_BUCKETS] = {};          // operations by how long they took, see latencyBucket
+};
+struct STRESS
+{
+    MEMORY memory;                                    // allocator state, one region per lock
+    vector<long long> base;                           // byte offset of each region in the arena
+    vector<unsigned char> bytes;                      // the arena handed out
+    REGION_LOCK* locks = nullptr;                     // one per region
+    vector<STRESS_THREAD> threads;                    // what each thread measured
+    POINT point;                                      // sizes and lifetimes of the blocks
+    unsigned seed = 1;                                // thread t draws from (seed, t)
+    atomic<bool> stop{false};                         // time is up
+};
+/***************************************************************************
+ * int latencyBucket(long long ns), long long bucketNs(int b)
+ * Description: bucket of a latency histogram with 8 buckets per power of two,
+ * so any percentile read from it is within 12.5%. bucketNs is the smallest
+ * latency in bucket b.
+ * Parameters:
+ * ns   I/P   long long   nanoseconds an operation took
+ * b    I/P   int         bucket
+**************************************************************************/
+inline int latencyBucket(long long ns)
+{
+    if (ns < 8)
+    {
+        return ns < 0 ? 0 : (int)ns;
+    }
+    int p = 63 - __builtin_clzll(ns);
+    return 8 * (p - 2) + (int)((ns >> (p - 3)) & 7);
+}
+long long bucketNs(int b)
+{
+    return b < 8 ? b : (8LL + b % 8) << (b / 8 - 1);
+}
+/***************************************************************************
+ * void lockRegion(REGION_LOCK& region, STRESS_THREAD& self)
+ * Description: takes a region's lock, counting it as contended when another
+ * thread holds it.
+ * Parameters:
+ * region   I/O   REGION_LOCK&     lock of the region
+ * self     I/O   STRESS_THREAD&   counts of the calling thread
+**************************************************************************/
+inline void lockRegion(REGION_LOCK& region, STRESS_THREAD& self)
+{
+    if (!region.lock.try_lock())
+    {
+        self.contended++;
+        region.lock.lock();
+    }
+    self.locked++;
+}
+/***************************************************************************
+ * bool stressAlloc(STRESS& stress, POLICY policy[], STRESS_THREAD& self, vector<RELEASE> cache[], int t, RELEASE& block)
+ * void stressFree(STRESS& stress, POLICY policy[], STRESS_THREAD& self, vector<RELEASE> cache[], const RELEASE& block)
+ * bool stressFlush(STRESS& stress, POLICY policy[], STRESS_THREAD& self, vector<RELEASE> cache[])
+ * Description: stressAlloc finds block.units units for thread t, from its cache
+ * or from the regions, and sets block.region and block.location. It returns
+ * false when there is no room even with the cache given back. stressFree keeps
+ * a freed block in the cache or returns it to its region. stressFlush returns
+ * every cached block, false if there were none.
+ * Parameters:
+ * stress   I/O   STRESS&           shared allocator
+ * policy   I/O   POLICY[]          placement policy of each region
+ * self     I/O   STRESS_THREAD&    counts of the calling thread
+ * cache    I/O   vector<RELEASE>[] blocks the thread kept back, by units
+ * t        I/P   int               calling thread, its home region is t % regions
+ * block    I/O   RELEASE&          block to allocate or free
+**************************************************************************/
+template <class POLICY>
+void stressFree(STRESS& stress, POLICY policy[], STRESS_THREAD& self, vector<RELEASE> cache[], const RELEASE& block)
+{
+    if (block.units <= STRESS_CACHE_UNITS && (int)cache[block.units].size() < STRESS_CACHE_BLOCKS)
+    {
+        cache[block.units].push_back(block);
+        return;
+    }
+    REGION& region = stress.memory.region[block.region];
+    lockRegion(stress.locks[block.region], self);
+    policy[block.region].released(region.mem, region.holes, block.location, block.units);
+    stress.locks[block.region].lock.unlock();
+}
+template <class POLICY>
+bool stressFlush(STRESS& stress, POLICY policy[], STRESS_THREAD& self, vector<RELEASE> cache[])
+{
+    bool flushed = false;
+    for(int units = 1; units <= STRESS_CACHE_UNITS; units++)
+    {
+        for(size_t b = 0; b < cache[units].size(); b++)
+        {
+            RELEASE& block = cache[units][b];
+            REGION& region = stress.memory.region[block.region];
+            lockRegion(stress.locks[block.region], self);
+            policy[block.region].released(region.mem, region.holes, block.location, block.units);
+            stress.locks[block.region].lock.unlock();
+            flushed = true;
+        }
+        cache[units].clear();
+    }
+    return flushed;
+}
+template <class POLICY>
+bool stressAlloc(STRESS& stress, POLICY policy[], STRESS_THREAD& self, vector<RELEASE> cache[], int t, RELEASE& block)
+{
+    self.allocs++;
+    if (block.units <= STRESS_CACHE_UNITS && !cache[block.units].empty())   // one this thread freed, no lock needed
+    {
+        block.region = cache[block.units].back().region;
+        block.location = cache[block.units].back().location;
+        cache[block.units].pop_back();
+        self.cached++;
+        return true;
+    }
+    MEMORY& memory = stress.memory;
+    do
+    {
+        for(int k=0; k<memory.count; k++)                               // home region first, then the others in turn
+        {
+            int r = (t + k) % memory.count;
+            REGION& region = memory.region[r];
+            lockRegion(stress.locks[r], self);
+            int put = policy[r].find(region.mem, region.holes, block.units, false);
+            if (put >= 0)
+            {
+                policy[r].placed(region.mem, region.holes, put, block.units);
+            }
+            stress.locks[r].lock.unlock();
+            if (put >= 0)
+            {
+                block.region = r;
+                block.location = put;
+                return true;
+            }
+        }
+    }while(stressFlush(stress, policy, self, cache));                   // give the cached blocks back and retry
+    self.failed++;
+    return false;
+}
+/***************************************************************************
+ * void stressThread(STRESS& stress, POLICY policy[], int t)
+ * Description: thread t of a stress run. Until stress.stop is set it frees its
+ * oldest block if it is due and otherwise allocates a new one, timing every
+ * operation into its latency histogram. Sizes and times are drawn a batch at
+ * a time outside the timed interval, so the histogram holds the allocator
+ * alone. Then it frees everything it holds.
+ * Parameters:
+ * stress   I/O   STRESS&    shared allocator
+ * policy   I/O   POLICY[]   placement policy of each region
+ * t        I/P   int        index of this thread
+**************************************************************************/
+template <class POLICY>
+void stressThread(STRESS& stress, POLICY policy[], int t)
+{
+    STRESS_THREAD& self = stress.threads[t];
+    RNG rng;
+    seedRng(rng, stress.seed, t);
+    int sizes[GEN_BATCH], times[GEN_BATCH], drawn = GEN_BATCH;
+    EVENTS live;                                                        // blocks held, by the operation that frees them
+    vector<RELEASE> cache[STRESS_CACHE_UNITS + 1];
+    unsigned char tag = (unsigned char)(t + 1);
+    long long op = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (!stress.stop.load(memory_order_relaxed))
+    {
+        if (!live.empty() && live.top().due <= op)                      // free the oldest block once it is due
+        {
+            const RELEASE& block = live.top();
+            const unsigned char* at = &stress.bytes[stress.base[block.region] + (long long)block.location * STRESS_UNIT_BYTES];
+            if (at[0] != tag || at[block.units * STRESS_UNIT_BYTES - 1] != tag)
+            {
+                self.overlaps++;
+            }
+            stressFree(stress, policy, self, cache, block);
+            live.pop();
+        }
+        else
+        {
+            if (drawn == GEN_BATCH)
+            {
+                fillColumn(sizes, GEN_BATCH, stress.point.size, rng);
+                fillColumn(times, GEN_BATCH, stress.point.time, rng);
+                drawn = 0;
+                start = chrono::steady_clock::now();                    // drawing the batch is not timed
+            }
+            RELEASE block;
+            block.units = policy[0].round(sizes[drawn]);
+            block.due = op + times[drawn++];
+            if (stressAlloc(stress, policy, self, cache, t, block))
+            {
+                memset(&stress.bytes[stress.base[block.region] + (long long)block.location * STRESS_UNIT_BYTES], tag,
+                       block.units * STRESS_UNIT_BYTES);
+                live.push(block);
+            }
+        }
+        op++;
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();   // one clock read per operation
+        self.latency[latencyBucket(chrono::duration_cast<chrono::nanoseconds>(now - start).count())]++;
+        start = now;
+    }
+    self.ops = op;
+    STRESS_THREAD untimed;                                              // giving everything back is not measured
+    for(; !live.empty(); live.pop())
+    {
+        stressFree(stress, policy, untimed, cache, live.top());
+    }
+    stressFlush(stress, policy, untimed, cache);
+}
+/***************************************************************************
+ * double stressPolicy(STRESS& stress, int threads)
+ * Description: runs POLICY as an allocator shared by threads threads for
+ * STRESS_SECONDS and returns the seconds it ran. Afterwards every unit must be
+ * free again, which is reported if it is not.
+ * Parameters:
+ * stress    I/O   STRESS&   allocator to run, point and seed set
+ * threads   I/P   int       number of threads
+**************************************************************************/
+template <class POLICY>
+double stressPolicy(STRESS& stress, int threads)
+{
+    MEMORY& memory = stress.memory;
+    initMemory(memory, stress.point.memSize, stress.point.regions);
+    vector<POLICY> regionPolicy(memory.count);
+    vector<REGION_LOCK> locks(memory.count);
+    stress.locks = locks.data();
+    stress.base.assign(memory.count, 0);
+    for(int r=0; r<memory.count; r++)
+    {
+        regionPolicy[r].init(memory.region[r].holes.size);
+        stress.base[r] = r > 0 ? stress.base[r-1] + (long long)memory.region[r-1].mem.size * STRESS_UNIT_BYTES : 0;
+    }
+    stress.bytes.assign((size_t)stress.point.memSize * STRESS_UNIT_BYTES, 0);
+    stress.threads.assign(threads, STRESS_THREAD());
+    stress.stop = false;
+    vector<thread> running;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(int t=0; t<threads; t++)
+    {
+        running.push_back(thread(stressThread<POLICY>, ref(stress), regionPolicy.data(), t));
+    }
+    this_thread::sleep_for(chrono::duration<double>(STRESS_SECONDS));
+    stress.stop = true;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for(size_t t=0; t<running.size(); t++)
+    {
+        running[t].join();
+    }
+    for(int r=0; r<memory.count; r++)                                   // everything was given back
+    {
+        REGION& region = memory.region[r];
+        regionPolicy[r].movable(region.mem, region.holes);              // quick fit keeps blocks of its own
+        if (region.holes.total != region.holes.size)
+        {
+            cerr << " region " << r << " lost " << region.holes.size - region.holes.total << " units" << endl;
+        }
+    }
+    stress.locks = nullptr;
+    return seconds;
+}
+/***************************************************************************
+ * void runStress(const POINT& point, const vector<int>& fits, int threads, unsigned seed)
+ * Description: runs each algorithm as an allocator shared by threads threads on
+ * the memory, regions and distributions of point, and prints its throughput,
+ * latency percentiles, share of region locks that were contended, share of
+ * allocations served by the thread caches and share that failed.
+ * Parameters:
+ * point     I/P   const POINT&         memory and workload
+ * fits      I/P   const vector<int>&   algorithms to run
+ * threads   I/P   int                  number of threads
+ * seed      I/P   unsigned             base seed, thread t uses (seed, t)
+**************************************************************************/
+typedef double (*STRESS_FIT)(STRESS&, int);
+const STRESS_FIT STRESS_FITS[NUM_FITS] = {stressPolicy<BEST_FIT>, stressPolicy<FIRST_FIT>, stressPolicy<NEXT_FIT>,
+                                          stressPolicy<WORST_FIT>, stressPolicy<BUDDY>, stressPolicy<QUICK_FIT>};
+void runStress(const POINT& point, const vector<int>& fits, int threads, unsigned seed)
+{
+    STRESS stress;
+    stress.point = point;
+    stress.seed = seed;
+    for(size_t f=0; f<fits.size(); f++)
+    {
+        int k = fits[f];
+        double seconds = STRESS_FITS[k](stress, threads);
+        STRESS_THREAD all;
+        for(int t=0; t<threads; t++)                                    // add up every thread
+        {
+            const STRESS_THREAD& self = stress.threads[t];
+            all.ops += self.ops;
+            all.allocs += self.allocs;
+            all.failed += self.failed;
+            all.cached += self.cached;
+            all.locked += self.locked;
+            all.contended += self.contended;
+            all.overlaps += self.overlaps;
+            for(int b=0; b<LATENCY_BUCKETS; b++)
+            {
+                all.latency[b] += self.latency[b];
+            }
+        }
+        const double quantiles[] = {0.5, 0.99, 0.999};
+        long long at[3] = {0, 0, 0}, seen = 0;
+        for(int b=0, q=0; b<LATENCY_BUCKETS && q<3; b++)                // first bucket that reaches each quantile
+        {
+            seen += all.latency[b];
+            for(; q<3 && seen >= quantiles[q] * all.ops; q++)
+            {
+                at[q] = bucketNs(b);
+            }
+        }
+        cout << " " << FIT_NAMES[k] << ": " << fixed << setprecision(2) << all.ops / seconds / 1e6 << " Mops/s"
+             << ", p50 " << at[0] << " ns, p99 " << at[1] << " ns, p99.9 " << at[2] << " ns" << setprecision(1)
+             << ", contended " << 100.0 * all.contended / max(all.locked, 1LL) << "%"
+             << ", cached " << 100.0 * all.cached / max(all.allocs, 1LL) << "%"
+             << ", failed " << 100.0 * all.failed / max(all.allocs, 1LL) << "%" << endl;
+        if (all.overlaps > 0)
+        {
+            cerr << " " << FIT_NAMES[k] << ": " << all.overlaps << " blocks were handed out twice" << endl;
+        }
+    }
+}
+/***************************************************************************
+ * int main( int argc, char *argv[] )
+ * Author: Venkata Bapanapalli
+ * Date: 19 April 2020
+ * Description: populates the info stream with random values for both size and time of task.
+ * Then runs all the algoritms 1000 times find the average and prints the results.
+ * Every point of the sweep grid is run in turn, in one process.
+ * --mem, --tasks, --size, --time, --compact, --movecost, --policies take comma separated
+ * lists that make up the grid, --trials N and --seed N set the experiments of each point and
+ * --config FILE reads the same options from a file (see readConfig). --ci W prints 95%
+ * confidence intervals, and differences from the first algorithm on the same streams, and
+ * stops each point once every interval is within W of its mean (see setOption).
+ * Tasks too big for the memory they may go to are rejected and their number is printed.
+ * --scan runs the reference scans of mem instead of the hole index, --verify runs both and
+ * replays a trace through a narrow stream window as well.
+ * --threads N runs the experiments on N worker threads.
+ * --trace FILE replays a workload file once through every algorithm and memory size instead.
+ * --metrics csv|json writes the metrics of every run and their means instead of the averages.
+ * --timeline FILE records every placement, release and tick of every run to FILE, Chrome
+ * trace JSON when it ends in .json (see TIMELINE).
+ * --checkpoint FILE checkpoints the run to FILE every --checkpoint-every S seconds (60) and,
+ * when FILE is there from an interrupted run of the same command, carries on from it.
+ * --bench runs the benchmarks instead, --bench-filter TEXT only those named with TEXT,
+ * --bench-time S runs each one for at least S seconds.
+ * --stress runs every algorithm as an allocator shared by --threads threads instead, for
+ * --stress-time S seconds each (1) at every point of the grid (see runStress).
+ * Parameters:
+ * argc    I/P    int        The number of arguments on the command line
+ * argv    I/P    char *[]   The arguments on the command line
+ * main    O/P    int        Status code, 1 when an option, config or trace is bad
+**************************************************************************/
+int main(int argc, char *argv[])
+{
+    SWEEP sweep;
+    RUNNER run;
+    string format;
+    int threads = thread::hardware_concurrency();
+    const char* tracePath = nullptr;
+    bool bench = false;
+    bool stress = false;
+    string filter;
+    CHECKPOINT checkpoint;
+    string timelinePath;
+    TIMELINE timeline;
+    for(int i=1; i<argc; i++)                                           // read the command line options
+    {
+        string option = argv[i];
+        if (option == "--scan")
+        {
+            SCAN_MEM = true;
+        }
+        else if (option == "--verify")
+        {
+            run.verify = true;
+        }
+        else if (option == "--threads" && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if (option == "--trace" && i + 1 < argc)
+        {
+            tracePath = argv[++i];
+        }
+        else if (option == "--metrics" && i + 1 < argc)
+        {
+            format = argv[++i];
+        }
+        else if (option == "--timeline" && i + 1 < argc)
+        {
+            timelinePath = argv[++i];
+        }
+        else if (option == "--checkpoint" && i + 1 < argc)
+        {
+            checkpoint.path = argv[++i];
+        }
+        else if (option == "--checkpoint-every" && i + 1 < argc)
+        {
+            checkpoint.every = atof(argv[++i]);
+        }
+        else if (option == "--bench")
+        {
+            bench = true;
+        }
+        else if (option == "--bench-filter" && i + 1 < argc)
+        {
+            bench = true;
+            filter = argv[++i];
+        }
+        else if (option == "--bench-time" && i + 1 < argc)
+        {
+            BENCH_SECONDS = atof(argv[++i]);
+        }
+        else if (option == "--stress")
+        {
+            stress = true;
+        }
+        else if (option == "--stress-time" && i + 1 < argc)
+        {
+            stress = true;
+            STRESS_SECONDS = atof(argv[++i]);
+        }
+        else if (option == "--config" && i + 1 < argc)
+        {
+            if (!readConfig(sweep, argv[++i]))
+            {
+                return 1;
+            }
+        }
+        else if (option.compare(0, 2, "--") == 0 && i + 1 < argc)      // --KEY VALUE sweep options
+        {
+            if (!setOption(sweep, option.substr(2), argv[++i]))
+            {
+                return 1;
+            }
+        }
+        else
+        {
+            cerr << " unknown option " << option << endl;
+            return 1;
+        }
+    }
+    vector<POINT> points;
+    for(int memSize : sweep.memSizes)                                   // every combination is a point
+    {
+        for(int tasks : sweep.tasks)
+        {
+            for(const DIST& size : sweep.sizes)
+            {
+                for(const DIST& time : sweep.times)
+                {
+                    POINT point = {memSize, tasks, size, time, COMPACTION(), SCHEDULER(), 1, SPILL_NONE};
+                    points.push_back(point);
+                }
+            }
+            if (tracePath != nullptr)                                   // a trace brings its own tasks
+            {
+                points.resize(points.size() - sweep.sizes.size() * sweep.times.size() + 1);
+                break;
+            }
+        }
+    }
+    vector<POINT> grid;
+    for(size_t p=0; p<points.size(); p++)                               // and every compaction setting
+    {
+        for(COMPACTION compact : sweep.compacts)
+        {
+            for(size_t m=0; m<sweep.moveCosts.size() && (m == 0 || compact.when != COMPACT_NEVER); m++)
+            {
+                compact.moveCost = sweep.moveCosts[m];
+                grid.push_back(points[p]);
+                grid.back().compact = compact;
+            }
+        }
+    }
+    points.swap(grid);
+    grid.clear();
+    for(size_t p=0; p<points.size(); p++)                               // and every scheduler
+    {
+        for(int order : sweep.orders)
+        {
+            for(size_t w=0; w<sweep.windows.size() && (w == 0 || order != ORDER_FIFO); w++)
+            {
+                grid.push_back(points[p]);
+                grid.back().sched = sweep.sched;
+                grid.back().sched.order = order;
+                grid.back().sched.window = sweep.windows[w];
+            }
+        }
+    }
+    points.swap(grid);
+    grid.clear();
+    for(size_t p=0; p<points.size(); p++)                               // and every partition of memory
+    {
+        for(int regions : sweep.regionCounts)
+        {
+            if (regions > points[p].memSize)
+            {
+                cerr << " " << regions << " regions do not fit in " << points[p].memSize << " units" << endl;
+                return 1;
+            }
+            for(size_t s=0; s<sweep.spills.size() && (s == 0 || regions > 1); s++)
+            {
+                grid.push_back(points[p]);
+                grid.back().regions = regions;
+                grid.back().spill = sweep.spills[s];
+            }
+        }
+    }
+    points.swap(grid);
+    if (sweep.fits.empty())
+    {
+        for(int k=0; k<NUM_FITS; k++)
+        {
+            sweep.fits.push_back(k);
+        }
+    }
+    if (bench)
+    {
+        runBenchmarks(filter, points[0]);
+        return 0;
+    }
+    if (stress)
+    {
+        for(size_t p=0; p<points.size(); p++)
+        {
+            if (points.size() > 1)
+            {
+                cout << pointName(points[p], nullptr) << endl;
+            }
+            runStress(points[p], sweep.fits, max(threads, 1), sweep.seed);
+        }
+        return 0;
+    }
+    run.fits = sweep.fits;
+    run.seed = sweep.seed;
+    if (!checkpoint.path.empty())                                       // carry on from the checkpoint if there is one
+    {
+        for(int i=1; i<argc; i++)                                       // every option but these decides the results
+        {
+            string option = argv[i];
+            if ((option == "--threads" || option == "--checkpoint" || option == "--checkpoint-every"
+                 || option == "--timeline") && i + 1 < argc)
+            {
+                i++;
+                continue;
+            }
+            checkpoint.command += option + " ";
+        }
+        if (!readCheckpoint(checkpoint) || checkpoint.resumePoints > (int)points.size())
+        {
+            return 1;
+        }
+        run.checkpoint = &checkpoint;
+    }
+    if (!timelinePath.empty() && !startTimeline(timeline, timelinePath, FIT_NAMES))
+    {
+        return 1;
+    }
+    run.ci = tracePath != nullptr ? -1 : sweep.ci;                      // a trace is one run
+    run.minTrials = sweep.minTrials;
+    run.keep = !format.empty() || run.checkpoint != nullptr || run.ci >= 0;
+    run.workers.resize(tracePath != nullptr ? 1 : max(threads, 1));
+    ostringstream aggregate;                                            // JSON means, written after every run
+    int rows = 0, means = 0;
+    if (format == "csv")
+    {
+        cout << "mem,tasks,size,time,compact,move_cost,sched,window,aging,slo,regions,spill,trial,policy,total_time,"
+             << "placements,failed,search_steps,mean_wait,max_wait,utilization,external_fragmentation,mean_holes,"
+             << "internal_fragmentation,compactions,units_moved,move_time,slo_missed,spilled,rejected,total_time_ci" << endl;
+    }
+    else if (format == "json")
+    {
+        cout << "{\"trials\":[";
+    }
+    for(size_t p=0; p<points.size(); p++)
+    {
+        run.point = points[p];
+        METRICS sum[NUM_FITS];
+        if ((int)p < checkpoint.resumePoints)                           // finished before the run was resumed
+        {
+            readPoint(checkpoint, run, sum);
+        }
+        else if (tracePath != nullptr)                                  // replay the trace through every algorithm
+        {
+            if (!replayTrace(run.workers[0], tracePath, run, sum))
+            {
+                return 1;
+            }
+            run.trials = 1;
+            run.results.assign(sum, sum + NUM_FITS);
+        }
+        else
+        {
+            run.trials = sweep.trials;
+            runPoint(run, sum);
+        }
+        if (run.checkpoint != nullptr)
+        {
+            savePoint(checkpoint, run, sum, !format.empty());
+        }
+        string fields = pointName(run.point, tracePath);
+        if (!format.empty())
+        {
+            ostringstream columns;                                      // point columns in front of every CSV row
+            columns << run.point.memSize << "," << (tracePath != nullptr ? string(",trace,trace")
+                    : to_string(run.point.tasks) + "," + distName(run.point.size) + "," + distName(run.point.time))
+                    << "," << compactName(run.point.compact) << "," << run.point.compact.moveCost
+                    << "," << ORDER_NAMES[run.point.sched.order] << "," << run.point.sched.window
+                    << "," << limitName(run.point.sched.aging) << "," << limitName(run.point.sched.slo)
+                    << "," << run.point.regions << "," << SPILL_NAMES[run.point.spill];
+            string prefix = format == "csv" ? columns.str() : "\"point\":\"" + fields + "\",";
+            for(size_t r=0; r<run.results.size(); r++)                 // every run, then the mean of each algorithm
+            {
+                int k = r % NUM_FITS;
+                if (find(run.fits.begin(), run.fits.end(), k) == run.fits.end())
+                {
+                    continue;
+                }
+                if (format == "json")
+                {
+                    cout << (rows++ > 0 ? ",\n" : "\n");
+                }
+                printMetrics(cout, format, prefix, to_string(r / NUM_FITS), FIT_NAMES[k], run.results[r], 1, -1);
+            }
+            for(size_t f=0; f<run.fits.size(); f++)
+            {
+                if (format == "json")
+                {
+                    aggregate << (means++ > 0 ? ",\n" : "\n");
+                }
+                printMetrics(format == "csv" ? cout : aggregate, format, prefix, "all", FIT_NAMES[run.fits[f]],
+                             sum[run.fits[f]], run.trials, run.ci >= 0 ? ciHalf(run.time[run.fits[f]]) : -1);
+            }
+            continue;
+        }
+        if (points.size() > 1)
+        {
+            cout << fields << endl;
+        }
+        for(size_t f=0; f<run.fits.size(); f++)
+        {
+            int k = run.fits[f];
+            cout << " " << FIT_NAMES[k] << ": ";
+            if (run.ci < 0 || run.time[k].n < 2)
+            {
+                cout << sum[k].totalTime/run.trials;
+            }
+            else                                                        // mean, interval and paired difference
+            {
+                cout << fixed << setprecision(1) << run.time[k].mean << " +- " << ciHalf(run.time[k]);
+                if (f > 0)
+                {
+                    cout << " (" << showpos << run.diff[k].mean << noshowpos << " +- " << ciHalf(run.diff[k])
+                         << " vs " << FIT_NAMES[run.fits[0]] << ")";
+                }
+            }
+            if (sum[k].waste > 0)                                       // only the rounding policies waste units
+            {
+                cout << " (internal fragmentation " << fixed << setprecision(1) << 100 * sum[k].waste / run.trials << "%)";
+            }
+            if (sum[k].rejected > 0)                                    // mean number of tasks too big to place
+            {
+                cout << " (rejected " << fixed << setprecision(1) << (double)sum[k].rejected / run.trials << " tasks of up to "
+                     << sum[k].rejectedUnits << " units, largest block " << sum[k].largestBlock << ")";
+            }
+            if (run.point.sched.slo != LLONG_MAX)                      // mean number of tasks that waited too long
+            {
+                cout << " (over SLO " << fixed << setprecision(1) << (double)sum[k].sloMissed / run.trials << ")";
+            }
+            cout << endl;
+        }
+        if (run.ci > 0 && run.trials < sweep.trials)
+        {
+            cout << " stopped after " << run.trials << " trials" << endl;
+        }
+    }
+    if (format == "json")
+    {
+        cout << "],\n\"aggregate\":[" << aggregate.str() << "]}" << endl;
+    }
+    if (run.checkpoint != nullptr)                                      // the run is complete
+    {
+        finishCheckpoints(checkpoint);
+    }
+    if (!timelinePath.empty())
+    {
+        finishTimeline(timeline);
+    }
+    return 0;
+}